@@ -0,0 +1,50 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <QByteArray>
+#include <QString>
+
+// Shared inputs so every benchmark measures the same workload between runs
+namespace BenchData {
+
+// Plain text, charsPerLine letters followed by a newline
+inline QString plainOutput(int lines, int charsPerLine)
+{
+    QString result;
+    result.reserve(lines * (charsPerLine + 1));
+    for (int i = 0; i < lines; ++i) {
+        for (int j = 0; j < charsPerLine; ++j) {
+            result.append(QChar('A' + (j % 26)));
+        }
+        result.append('\n');
+    }
+    return result;
+}
+
+// Cursor movement, erase and SGR heavy output, similar to a full-screen redraw
+inline QString ansiOutput(int count)
+{
+    QString result;
+    result.reserve(count * 50);
+    for (int i = 0; i < count; ++i) {
+        result.append("\033[H\033[2J\033[1;31mLine ").append(QString::number(i));
+        result.append("\033[0m\033[10;20H\033[32;44mTest\033[0m\n");
+    }
+    return result;
+}
+
+// Colored `ls --color` style listing
+inline QByteArray coloredListing(int lines)
+{
+    QByteArray result;
+    for (int i = 0; i < lines; ++i) {
+        result.append("-rwxr-xr-x 1 user user  4096 Jan  1 12:00 \033[01;32mfile");
+        result.append(QByteArray::number(i));
+        result.append("\033[0m  \033[01;34mdirectory\033[0m  \033[38;5;208mlink\033[0m\r\n");
+    }
+    return result;
+}
+
+} // namespace BenchData
+
+#endif // BENCHDATA_H
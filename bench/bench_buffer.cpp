@@ -0,0 +1,91 @@
+#include "TerminalBuffer.h"
+#include <benchmark/benchmark.h>
+
+static void BM_BufferAppend(benchmark::State& state)
+{
+    const QString line(80, 'X');
+    const int lines = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        TerminalBuffer buffer;
+        buffer.setMaxScrollback(lines);
+        for (int i = 0; i < lines; ++i) {
+            buffer.appendLine(line);
+        }
+        benchmark::DoNotOptimize(buffer.lineCount());
+    }
+    state.SetItemsProcessed(state.iterations() * lines);
+}
+BENCHMARK(BM_BufferAppend)->Arg(10000);
+
+// Appending to a full buffer, where each line evicts the oldest one
+static void BM_BufferAppendAtLimit(benchmark::State& state)
+{
+    const QString line(80, 'X');
+    const int limit = static_cast<int>(state.range(0));
+    TerminalBuffer buffer;
+    buffer.setMaxScrollback(limit);
+    for (int i = 0; i < limit; ++i) {
+        buffer.appendLine(line);
+    }
+
+    for (auto _ : state) {
+        buffer.appendLine(line);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BufferAppendAtLimit)->Arg(10000)->Arg(100000);
+
+static void BM_BufferScrollbackRead(benchmark::State& state)
+{
+    const int limit = 100000;
+    TerminalBuffer buffer;
+    buffer.setMaxScrollback(limit);
+    for (int i = 0; i < limit; ++i) {
+        buffer.appendLine(QString::number(i));
+    }
+
+    int index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.getLine(index));
+        index = (index + 7919) % limit;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BufferScrollbackRead);
+
+// Reading the visible window, as a display update does: copy vs. view
+static void BM_BufferVisibleCopy(benchmark::State& state)
+{
+    TerminalBuffer buffer(50, 200);
+    for (int i = 0; i < 10000; ++i) {
+        buffer.appendLine(QString::number(i));
+    }
+
+    for (auto _ : state) {
+        int length = 0;
+        for (const QString& line : buffer.getVisibleLines()) {
+            length += line.size();
+        }
+        benchmark::DoNotOptimize(length);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer.rows());
+}
+BENCHMARK(BM_BufferVisibleCopy);
+
+static void BM_BufferVisibleView(benchmark::State& state)
+{
+    TerminalBuffer buffer(50, 200);
+    for (int i = 0; i < 10000; ++i) {
+        buffer.appendLine(QString::number(i));
+    }
+
+    for (auto _ : state) {
+        int length = 0;
+        for (const QString& line : buffer.visibleLines()) {
+            length += line.size();
+        }
+        benchmark::DoNotOptimize(length);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer.rows());
+}
+BENCHMARK(BM_BufferVisibleView);
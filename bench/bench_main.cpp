@@ -0,0 +1,19 @@
+#include <QApplication>
+#include <benchmark/benchmark.h>
+
+int main(int argc, char* argv[])
+{
+    // The paint benchmarks need a QApplication but never a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
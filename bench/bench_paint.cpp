@@ -0,0 +1,23 @@
+#include "BenchData.h"
+#include "TerminalView.h"
+#include <QImage>
+#include <benchmark/benchmark.h>
+
+// Repaint a full 24x80 view of colored text into an image, as one frame would
+static void BM_PaintFullScreen(benchmark::State& state)
+{
+    TerminalView view;
+    view.setAttribute(Qt::WA_DontShowOnScreen);
+    view.resize(800, 480);
+
+    QImage frame(view.size(), QImage::Format_RGB32);
+    view.render(&frame);
+    view.setDimensions(24, 80);
+    view.displayOutput(BenchData::coloredListing(24));
+
+    for (auto _ : state) {
+        view.render(&frame);
+    }
+    state.SetItemsProcessed(state.iterations() * 24 * 80);
+}
+BENCHMARK(BM_PaintFullScreen)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,88 @@
+#include "ANSIParser.h"
+#include "BenchData.h"
+#include "ControlScan.h"
+#include "TerminalEmulator.h"
+#include <benchmark/benchmark.h>
+
+static void BM_ANSIParserPlain(benchmark::State& state)
+{
+    const QString input = BenchData::plainOutput(static_cast<int>(state.range(0)), 80);
+    for (auto _ : state) {
+        ANSIParser parser;
+        benchmark::DoNotOptimize(parser.parseToTokens(input));
+    }
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(QChar));
+}
+BENCHMARK(BM_ANSIParserPlain)->Arg(1000);
+
+static void BM_ANSIParserComplex(benchmark::State& state)
+{
+    const QString input = BenchData::ansiOutput(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        ANSIParser parser;
+        benchmark::DoNotOptimize(parser.parseToTokens(input));
+    }
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(QChar));
+}
+BENCHMARK(BM_ANSIParserComplex)->Arg(1000);
+
+// Same input into the reused token arena: no per-token strings
+static void BM_ANSIParserComplexView(benchmark::State& state)
+{
+    const QString input = BenchData::ansiOutput(static_cast<int>(state.range(0)));
+    ANSIParser parser;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.parseToView(input).size());
+    }
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(QChar));
+}
+BENCHMARK(BM_ANSIParserComplexView)->Arg(1000);
+
+// Full emulator path: UTF-8 decode, state machine and screen updates
+static void BM_EmulatorColoredListing(benchmark::State& state)
+{
+    const QByteArray input = BenchData::coloredListing(static_cast<int>(state.range(0)));
+    const int chunkSize = 4096;
+    for (auto _ : state) {
+        TerminalEmulator emulator(24, 80);
+        for (int offset = 0; offset < input.size(); offset += chunkSize) {
+            emulator.processData(input.mid(offset, chunkSize));
+        }
+        benchmark::DoNotOptimize(emulator.sequenceCount());
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_EmulatorColoredListing)->Arg(2000);
+
+// Finding the end of printable runs in 100k lines of plain output: the dispatched
+// SIMD scan against the scalar loop
+static void BM_ControlScan(benchmark::State& state)
+{
+    const QString input = BenchData::plainOutput(100000, 80);
+    const char16_t* begin = reinterpret_cast<const char16_t*>(input.constData());
+    const char16_t* end = begin + input.size();
+    const bool simd = state.range(0) != 0;
+    for (auto _ : state) {
+        int runs = 0;
+        for (const char16_t* pos = begin; pos < end; ++pos) {
+            pos = simd ? Escape::findControl(pos, end) : Escape::findControlScalar(pos, end);
+            ++runs;
+        }
+        benchmark::DoNotOptimize(runs);
+    }
+    state.SetLabel(simd ? Escape::controlScanImplementation() : "scalar");
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(QChar));
+}
+BENCHMARK(BM_ControlScan)->Arg(0)->Arg(1);
+
+static void BM_EmulatorPlainOutput(benchmark::State& state)
+{
+    const QString input = BenchData::plainOutput(static_cast<int>(state.range(0)), 80);
+    for (auto _ : state) {
+        TerminalEmulator emulator(24, 80);
+        emulator.processData(input);
+        benchmark::DoNotOptimize(emulator.screen().cursorRow());
+    }
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(QChar));
+}
+BENCHMARK(BM_EmulatorPlainOutput)->Arg(100000);
@@ -0,0 +1,43 @@
+#include "ProfileStorage.h"
+#include <QTemporaryDir>
+#include <benchmark/benchmark.h>
+
+static void BM_ProfileLoadAll(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        state.SkipWithError("Cannot create temporary directory");
+        return;
+    }
+
+    ProfileStorage storage(dir.path());
+    const int count = static_cast<int>(state.range(0));
+    for (int i = 0; i < count; ++i) {
+        storage.saveProfile(ConnectionProfile(QString("profile%1").arg(i),
+                                              QString("host%1.example.com").arg(i), 22,
+                                              QString("user%1").arg(i)));
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(storage.loadAllProfiles());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ProfileLoadAll)->Arg(100);
+
+static void BM_ProfileSave(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        state.SkipWithError("Cannot create temporary directory");
+        return;
+    }
+
+    ProfileStorage storage(dir.path());
+    ConnectionProfile profile("profile", "host.example.com", 22, "user");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(storage.saveProfile(profile));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProfileSave);
@@ -0,0 +1,79 @@
+#include "TerminalScreen.h"
+#include <benchmark/benchmark.h>
+
+// Fill the whole screen character by character, wrapping at the right margin
+static void BM_ScreenPutChar(benchmark::State& state)
+{
+    TerminalScreen screen(24, 80);
+    const int cells = 24 * 80;
+    for (auto _ : state) {
+        screen.setCursorPos(0, 0);
+        for (int i = 0; i < cells - 1; ++i) {
+            screen.putChar(QChar('A' + (i % 26)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (cells - 1));
+}
+BENCHMARK(BM_ScreenPutChar);
+
+// One screenful through putText(): ASCII (0) against CJK (1), which takes the width
+// lookup and two cells per character. Items are cells.
+static void BM_ScreenPutText(benchmark::State& state)
+{
+    TerminalScreen screen(24, 80);
+    QString text;
+    for (int i = 0; i < 24 * 80 - 1; ++i) {
+        text += state.range(0) ? QChar(0x4e00 + (i % 512)) : QChar('A' + (i % 26));
+    }
+    for (auto _ : state) {
+        screen.setCursorPos(0, 0);
+        screen.putText(text.constData(), state.range(0) ? text.size() / 2 : text.size());
+    }
+    state.SetItemsProcessed(state.iterations() * (24 * 80 - 1));
+}
+BENCHMARK(BM_ScreenPutText)->Arg(0)->Arg(1);
+
+// Scroll with the history at its limit so every row also evicts an old line
+static void BM_ScreenScrollUp(benchmark::State& state)
+{
+    TerminalScreen screen(24, 80);
+    screen.setMaxScrollback(1000);
+    for (int row = 0; row < 24; ++row) {
+        screen.setCursorPos(row, 0);
+        for (int col = 0; col < 80; ++col) {
+            screen.putChar('x');
+        }
+    }
+    for (int i = 0; i < 1100; ++i) {
+        screen.scrollUp();
+    }
+
+    for (auto _ : state) {
+        screen.scrollUp();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScreenScrollUp);
+
+static void BM_ScreenEraseLine(benchmark::State& state)
+{
+    TerminalScreen screen(24, 80);
+    for (auto _ : state) {
+        for (int row = 0; row < 24; ++row) {
+            screen.setCursorPos(row, 0);
+            screen.clearLine();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 24);
+}
+BENCHMARK(BM_ScreenEraseLine);
+
+static void BM_ScreenEraseDisplay(benchmark::State& state)
+{
+    TerminalScreen screen(24, 80);
+    for (auto _ : state) {
+        screen.clearScreen();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScreenEraseDisplay);
@@ -1,7 +1,11 @@
 #ifndef ANSIPARSER_H
 #define ANSIPARSER_H
 
+#include "EscapeTokenizer.h"
+#include "Utf8Decoder.h"
+#include <QByteArray>
 #include <QString>
+#include <QStringView>
 #include <QVector>
 #include <QColor>
 
@@ -55,6 +59,14 @@ public:
             foregroundColor = Color::Default;
             backgroundColor = Color::Default;
         }
+
+        bool operator==(const TextFormat& other) const {
+            return bold == other.bold && italic == other.italic &&
+                   underline == other.underline && inverse == other.inverse &&
+                   foregroundColor == other.foregroundColor &&
+                   backgroundColor == other.backgroundColor;
+        }
+        bool operator!=(const TextFormat& other) const { return !(*this == other); }
     };
 
     struct Command {
@@ -69,15 +81,99 @@ public:
         TextFormat format;
     };
 
+    // Tokens of one parse without per-token strings: each token is a slice of the
+    // parser's text arena (the input with escape sequences removed) plus an index
+    // into the interned formats. Valid until the next parseToView() or feed().
+    class TokenView {
+    public:
+        struct Span {
+            int offset;
+            int length;
+            int format;
+        };
+
+        struct Ref {
+            QStringView text;
+            const TextFormat* format;
+        };
+
+        class const_iterator {
+        public:
+            const_iterator(const TokenView* view, int index) : m_view(view), m_index(index) {}
+            Ref operator*() const { return m_view->at(m_index); }
+            const_iterator& operator++() { ++m_index; return *this; }
+            bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+            bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+        private:
+            const TokenView* m_view;
+            int m_index;
+        };
+
+        TokenView() = default;
+        TokenView(const QChar* text, int textLength, const Span* spans, int count,
+                  const TextFormat* formats)
+            : m_text(text), m_textLength(textLength), m_spans(spans), m_count(count),
+              m_formats(formats) {}
+
+        int size() const { return m_count; }
+        bool isEmpty() const { return m_count == 0; }
+        Ref at(int i) const {
+            const Span& span = m_spans[i];
+            return Ref{QStringView(m_text + span.offset, span.length), &m_formats[span.format]};
+        }
+        Ref operator[](int i) const { return at(i); }
+        // All text of the parse, escape sequences removed
+        QStringView text() const { return QStringView(m_text, m_textLength); }
+        // Index of token i's format; equal indices mean equal formats
+        int formatIndex(int i) const { return m_spans[i].format; }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_count); }
+
+    private:
+        const QChar* m_text = nullptr;
+        int m_textLength = 0;
+        const Span* m_spans = nullptr;
+        int m_count = 0;
+        const TextFormat* m_formats = nullptr;
+    };
+
     // Constructor
     ANSIParser();
 
     // Parsing methods
     QString parse(const QString& input);
     QVector<Token> parseToTokens(const QString& input);
+    // Like parseToTokens() but into storage the parser reuses: no allocation per
+    // token, none at all once the arena has grown to the input size
+    TokenView parseToView(const QString& input);
+    // Decodes one CSI sequence making up the whole string, e.g. "\x1b[10;20H"; anything
+    // else, private sequences included, is CommandType::None. Missing and zero
+    // parameters take their ECMA-48 defaults as in the emulator ("\x1b[0A" and
+    // "\x1b[A" both move one row); params holds the values as sent, empty ones as 0.
     Command parseCommand(const QString& sequence);
 
-    // State queries
+    // Streaming parse for data that arrives in chunks, such as socket reads. Unlike
+    // parse() and parseToTokens(), the format and a sequence or UTF-8 character cut
+    // off at the end of a chunk carry over to the next call. The returned view is
+    // valid until the next feed() or parseToView().
+    TokenView feed(const QString& chunk);
+    TokenView feed(const QByteArray& bytes);
+    // Same without token storage: onText(const QChar* text, int length,
+    // const TextFormat& format) is called for each run of text
+    template <typename TextHandler>
+    void feed(const QString& chunk, TextHandler&& onText)
+    {
+        const QChar* begin = chunk.constData();
+        m_hasEscapeSequences =
+            tokenize(m_stream, m_streamFormat, begin, begin + chunk.size(), onText);
+        m_currentFormat = m_streamFormat;
+    }
+    // Drops stream state: open sequence, pending UTF-8 bytes and the format
+    void resetStream();
+
+    // State queries; the format is the one in effect after the last parse or feed
     bool hasEscapeSequences() const;
     TextFormat currentFormat() const;
 
@@ -85,22 +181,66 @@ public:
     static QColor toQColor(Color color);
 
 private:
-    struct ParseState {
-        int position = 0;
-        TextFormat format;
-        QString currentText;
-        QVector<Token> tokens;
-    };
+    using Tokenizer = Escape::Tokenizer<QChar>;
 
-    void processEscapeSequence(const QString& input, ParseState& state);
-    void processSGR(const QVector<int>& params, ParseState& state);
-    void applyFormatChange(int param, ParseState& state);
-    QVector<int> extractParameters(const QString& sequence);
-    bool isEscapeSequenceStart(const QString& input, int pos) const;
-    int findSequenceEnd(const QString& input, int start) const;
+    // Passes the text in [pos, end) to onText, applying SGR sequences to format.
+    // Controls such as newlines stay in the text. Returns whether any escape
+    // sequence was seen.
+    template <typename TextHandler>
+    static bool tokenize(Tokenizer& tokenizer, TextFormat& format, const QChar* pos,
+                         const QChar* end, TextHandler&& onText)
+    {
+        bool sawEscape = false;
+        Tokenizer::Token token;
+        while (tokenizer.next(pos, end, token)) {
+            switch (token.type) {
+            case Tokenizer::TokenType::Text:
+            case Tokenizer::TokenType::Control:
+                onText(token.text, token.length, static_cast<const TextFormat&>(format));
+                break;
+            case Tokenizer::TokenType::Csi:
+                sawEscape = true;
+                if (token.csi->final == 'm' && !token.csi->isPrivate()) {
+                    applySgr(*token.csi, format);
+                }
+                // Cursor movement and erase are left to the terminal emulator
+                break;
+            case Tokenizer::TokenType::Esc:
+            case Tokenizer::TokenType::String:
+                sawEscape = true;
+                break;
+            }
+        }
+        return sawEscape;
+    }
+
+    // Text of all tokens back to back, the token spans and the distinct formats.
+    // Cleared, not freed, between parses.
+    struct TokenArena {
+        QString text;
+        QVector<TokenView::Span> spans;
+        QVector<TextFormat> formats;
+        int lastFormat = -1;
+
+        void clear();
+        // Appends to the last span when the format is unchanged
+        void append(const QChar* run, int length, const TextFormat& format);
+        int intern(const TextFormat& format);
+        TokenView view() const;
+    };
+    static void applySgr(const Escape::CsiCommand& csi, TextFormat& format);
+    static Command toCommand(const Escape::CsiCommand& csi);
 
     TextFormat m_currentFormat;
     bool m_hasEscapeSequences;
+
+    TokenArena m_arena;
+
+    // Streaming state, independent of the one-shot parse methods
+    Tokenizer m_stream;
+    TextFormat m_streamFormat;
+    Unicode::Utf8Decoder m_utf8;
+    QString m_decoded;
 };
 
 #endif // ANSIPARSER_H
@@ -0,0 +1,78 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include <QJsonObject>
+#include <QtGlobal>
+#include <cstddef>
+
+// Heap allocation accounting per subsystem, for proving that hot paths do not
+// allocate. Builds configured with ENABLE_ALLOC_TRACKING replace the global operator
+// new/delete (and, on glibc, malloc/free, which Qt's containers use) with versions
+// that count against the subsystem tagged by the innermost ALLOC_SCOPE() on the
+// calling thread. Frees count against the subsystem that releases the memory.
+//
+// Without ENABLE_ALLOC_TRACKING, ALLOC_SCOPE() compiles away and all counts are zero.
+class AllocTracker {
+public:
+    enum Subsystem {
+        Untagged,
+        Parser,
+        Screen,
+        Scrollback,
+        Io,
+        Ui,
+        SubsystemCount
+    };
+
+    struct Counts {
+        quint64 allocations = 0;
+        quint64 bytes = 0;
+        quint64 frees = 0;
+    };
+
+    static constexpr bool isCompiledIn()
+    {
+#ifdef SSH_CLIENT_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static Counts counts(Subsystem subsystem);
+    static Counts total();
+    static const char* subsystemName(Subsystem subsystem);
+
+    // {"parser": {"allocations": ..., "bytes": ..., "frees": ...}, ...}
+    static QJsonObject toJson();
+
+    static Subsystem currentSubsystem();
+
+    // Called by the replaced allocation functions
+    static void recordAllocation(std::size_t bytes);
+    static void recordFree();
+
+    // Tags allocations on this thread until destroyed; use through ALLOC_SCOPE()
+    class Scope {
+    public:
+        explicit Scope(Subsystem subsystem);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Subsystem m_previous;
+    };
+};
+
+#ifdef SSH_CLIENT_ALLOC_TRACKING
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+#define ALLOC_SCOPE(subsystem) \
+    AllocTracker::Scope ALLOC_CONCAT(allocScope, __LINE__)(AllocTracker::subsystem)
+#else
+#define ALLOC_SCOPE(subsystem) static_cast<void>(0)
+#endif
+
+#endif // ALLOCTRACKER_H
@@ -0,0 +1,129 @@
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <type_traits>
+
+// Compact binary log format shared by Logger (binary mode) and the blog-decode tool.
+//
+// A file starts with a 16-byte header (magic, version) followed by records. Every
+// record has a fixed 20-byte little-endian header:
+//
+//   u32 length      whole record including this header; 0 marks the end of data
+//   u8  kind        RecordKind
+//   u8  level       QtMsgType
+//   u16 category    id introduced by a CategoryDef record in the same file
+//   u32 format      id introduced by a FormatDef record in the same file
+//   u64 timestamp   microseconds since the Unix epoch
+//
+// Message records carry their arguments unformatted (type tag + value each), so the
+// cost of turning them into text is paid only by the decoder. Each file repeats the
+// definitions it uses and can be decoded on its own.
+namespace BinaryLog {
+
+constexpr char Magic[8] = {'S', 'S', 'H', 'B', 'L', 'O', 'G', '\0'};
+constexpr quint32 Version = 1;
+constexpr int FileHeaderSize = 16;
+constexpr int RecordHeaderSize = 20;
+
+enum class RecordKind : quint8 {
+    CategoryDef = 1, // payload: category name
+    FormatDef = 2,   // payload: format string with %1..%n placeholders
+    Message = 3,     // payload: encoded arguments for `format`
+    Text = 4         // payload: preformatted UTF-8 message (plain qDebug() output)
+};
+
+enum class ArgType : quint8 { Int = 1, UInt = 2, Double = 3, String = 4 };
+
+struct RecordHeader {
+    quint32 length = 0;
+    RecordKind kind = RecordKind::Text;
+    quint8 level = 0;
+    quint16 category = 0;
+    quint32 format = 0;
+    quint64 timestampUs = 0;
+};
+
+QByteArray fileHeader();
+bool checkFileHeader(const char* data, qint64 size);
+
+void appendRecord(QByteArray& out, const RecordHeader& header, const QByteArray& payload);
+
+// Reads the record at `offset` and advances it. Returns false at the end of data or on
+// a truncated record.
+bool readRecord(const char* data, qint64 size, qint64& offset, RecordHeader& header,
+                QByteArray& payload);
+
+// Call-site format registry. Ids start at 1 and are stable for the process lifetime;
+// extra arguments are accepted so the logging macros can pass their argument list.
+quint32 registerFormatString(const char* format);
+QByteArray formatString(quint32 id);
+
+template <typename... Args>
+quint32 registerFormat(const char* format, const Args&...)
+{
+    return registerFormatString(format);
+}
+
+// Argument encoding
+void encodeInt(QByteArray& out, qint64 value);
+void encodeUInt(QByteArray& out, quint64 value);
+void encodeDouble(QByteArray& out, double value);
+void encodeString(QByteArray& out, const QByteArray& utf8);
+
+inline void encodeString(QByteArray& out, const QString& value)
+{
+    encodeString(out, value.toUtf8());
+}
+
+inline void encodeString(QByteArray& out, const char* value)
+{
+    encodeString(out, QByteArray(value));
+}
+
+template <typename T>
+void encodeArg(QByteArray& out, const T& value)
+{
+    if constexpr (std::is_same<T, bool>::value) {
+        encodeInt(out, value ? 1 : 0);
+    } else if constexpr (std::is_enum<T>::value) {
+        encodeInt(out, static_cast<qint64>(value));
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        encodeInt(out, static_cast<qint64>(value));
+    } else if constexpr (std::is_integral<T>::value) {
+        encodeUInt(out, static_cast<quint64>(value));
+    } else if constexpr (std::is_floating_point<T>::value) {
+        encodeDouble(out, static_cast<double>(value));
+    } else {
+        encodeString(out, value);
+    }
+}
+
+// Encodes everything after the format string
+template <typename... Args>
+QByteArray encodeArgs(const char*, const Args&... args)
+{
+    QByteArray out;
+    (encodeArg(out, args), ...);
+    return out;
+}
+
+QStringList decodeArgs(const QByteArray& payload);
+
+// Substitutes %1..%99 with the arguments in a single pass, so '%' inside an argument
+// is left alone
+QString render(const QString& format, const QStringList& args);
+
+// One log line in the text log's layout:
+// [yyyy-MM-dd hh:mm:ss.zzz] [LEVEL] [category] message
+QByteArray formatLine(quint64 timestampUs, int level, const char* category,
+                      const QString& message);
+
+quint64 currentTimestampUs();
+
+} // namespace BinaryLog
+
+#endif // BINARYLOG_H
@@ -0,0 +1,20 @@
+#ifndef CHARWIDTH_H
+#define CHARWIDTH_H
+
+// Terminal column width of a Unicode code point: 0 for combining marks and other
+// zero-width characters, 2 for East Asian Wide and Fullwidth characters, 1 otherwise.
+// Controls are never measured; the tokenizer has taken them out of the text.
+namespace Unicode {
+
+// Two-level table lookup, O(1); the table is generated at compile time
+int tableWidth(char32_t cp);
+
+inline int charWidth(char32_t cp)
+{
+    // Latin-1 and everything up to the combining diacritics is one column
+    return cp < 0x300 ? 1 : tableWidth(cp);
+}
+
+} // namespace Unicode
+
+#endif // CHARWIDTH_H
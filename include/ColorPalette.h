@@ -0,0 +1,125 @@
+#ifndef COLORPALETTE_H
+#define COLORPALETTE_H
+
+#include <QColor>
+#include <QString>
+#include <QVector>
+#include <array>
+
+// Colour as stored in a cell: a palette index, the theme's default foreground or
+// background, or a direct RGB value. Cells are only resolved against a ColorTheme
+// when painted, so switching themes recolours the screen and the whole scrollback
+// without touching a cell.
+class TerminalColor {
+public:
+    constexpr TerminalColor() : m_value(DefaultForegroundKind) {}
+
+    static constexpr TerminalColor defaultForeground()
+    {
+        return TerminalColor(DefaultForegroundKind);
+    }
+    static constexpr TerminalColor defaultBackground()
+    {
+        return TerminalColor(DefaultBackgroundKind);
+    }
+    static constexpr TerminalColor indexed(int index)
+    {
+        return TerminalColor(IndexedKind | (static_cast<quint32>(index) & 0xff));
+    }
+    static constexpr TerminalColor rgb(int r, int g, int b)
+    {
+        return TerminalColor(RgbKind | (qRgb(r, g, b) & 0xffffff));
+    }
+
+    constexpr bool isIndexed() const { return (m_value & KindMask) == IndexedKind; }
+    constexpr bool isRgb() const { return (m_value & KindMask) == RgbKind; }
+    constexpr int index() const { return static_cast<int>(m_value & 0xff); }
+    constexpr QRgb rgbValue() const { return 0xff000000u | (m_value & 0xffffff); }
+
+    constexpr bool operator==(TerminalColor other) const { return m_value == other.m_value; }
+    constexpr bool operator!=(TerminalColor other) const { return m_value != other.m_value; }
+
+private:
+    static constexpr quint32 KindMask = 0xff000000u;
+    static constexpr quint32 IndexedKind = 0x00000000u;
+    static constexpr quint32 RgbKind = 0x01000000u;
+    static constexpr quint32 DefaultForegroundKind = 0x02000000u;
+    static constexpr quint32 DefaultBackgroundKind = 0x03000000u;
+
+    constexpr explicit TerminalColor(quint32 value) : m_value(value) {}
+
+    quint32 m_value;
+};
+
+namespace ColorPalette {
+
+using Palette = std::array<QRgb, 256>;
+using BaseColors = std::array<QRgb, 16>;
+
+// The 16 ANSI colours the terminal has always used (VGA text mode)
+constexpr BaseColors Vga = {{
+    qRgb(0, 0, 0), qRgb(170, 0, 0), qRgb(0, 170, 0), qRgb(170, 85, 0),
+    qRgb(0, 0, 170), qRgb(170, 0, 170), qRgb(0, 170, 170), qRgb(170, 170, 170),
+    qRgb(85, 85, 85), qRgb(255, 85, 85), qRgb(85, 255, 85), qRgb(255, 255, 85),
+    qRgb(85, 85, 255), qRgb(255, 85, 255), qRgb(85, 255, 255), qRgb(255, 255, 255),
+}};
+
+// 256-colour palette: the 16 base colours, the xterm 6x6x6 colour cube and 24 greys
+constexpr Palette build(const BaseColors& base)
+{
+    Palette palette{};
+    for (int i = 0; i < 16; ++i) {
+        palette[i] = base[i];
+    }
+
+    constexpr int levels[6] = {0, 95, 135, 175, 215, 255};
+    for (int i = 0; i < 216; ++i) {
+        palette[16 + i] = qRgb(levels[i / 36], levels[(i / 6) % 6], levels[i % 6]);
+    }
+
+    for (int i = 0; i < 24; ++i) {
+        const int gray = 8 + i * 10;
+        palette[232 + i] = qRgb(gray, gray, gray);
+    }
+    return palette;
+}
+
+constexpr Palette Default = build(Vga);
+
+static_assert(Default[1] == qRgb(170, 0, 0), "base colours come first");
+static_assert(Default[196] == qRgb(255, 0, 0), "colour cube starts at 16");
+static_assert(Default[255] == qRgb(238, 238, 238), "grey ramp ends at 255");
+
+} // namespace ColorPalette
+
+// Default colours plus a 256-colour palette
+struct ColorTheme {
+    QString name;
+    QRgb foreground = ColorPalette::Vga[7];
+    QRgb background = ColorPalette::Vga[0];
+    ColorPalette::Palette palette = ColorPalette::Default;
+
+    QRgb resolve(TerminalColor color) const
+    {
+        if (color.isIndexed()) {
+            return palette[color.index()];
+        }
+        if (color.isRgb()) {
+            return color.rgbValue();
+        }
+        return color == TerminalColor::defaultForeground() ? foreground : background;
+    }
+
+    static const ColorTheme& defaultTheme();
+
+    // Built-in themes followed by the user's themes (*.json in the "themes" folder of
+    // the application data directory), read once on first use
+    static const QVector<ColorTheme>& available();
+    static const ColorTheme* find(const QString& name);
+
+    // {"name": "...", "foreground": "#rrggbb", "background": "#rrggbb",
+    //  "colors": [16 x "#rrggbb"]}; the rest of the palette is generated
+    static bool fromJson(const QByteArray& json, ColorTheme& theme, QString* error = nullptr);
+};
+
+#endif // COLORPALETTE_H
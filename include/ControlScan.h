@@ -0,0 +1,41 @@
+#ifndef CONTROLSCAN_H
+#define CONTROLSCAN_H
+
+#include <QChar>
+#include <QVector>
+
+// Finds the end of a printable run: the first C0 control, ESC or DEL in [pos, end),
+// or end. Uses AVX2 or SSE2 when the CPU has them (chosen once at first use) and a
+// scalar loop elsewhere.
+namespace Escape {
+
+const char16_t* findControl(const char16_t* pos, const char16_t* end);
+const char* findControl(const char* pos, const char* end);
+
+inline const QChar* findControl(const QChar* pos, const QChar* end)
+{
+    // QChar is a single UTF-16 code unit
+    return reinterpret_cast<const QChar*>(findControl(reinterpret_cast<const char16_t*>(pos),
+                                                      reinterpret_cast<const char16_t*>(end)));
+}
+
+// Plain loops, for comparison in benchmarks
+const char16_t* findControlScalar(const char16_t* pos, const char16_t* end);
+const char* findControlScalar(const char* pos, const char* end);
+
+// "avx2", "sse2" or "scalar"
+const char* controlScanImplementation();
+
+struct ControlScanner {
+    const char* name;
+    const char16_t* (*scan16)(const char16_t*, const char16_t*);
+    const char* (*scan8)(const char*, const char*);
+};
+
+// Every implementation this build and CPU can run, fastest (the dispatched one) first;
+// for checking them against each other
+QVector<ControlScanner> controlScanImplementations();
+
+} // namespace Escape
+
+#endif // CONTROLSCAN_H
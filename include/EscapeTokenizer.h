@@ -0,0 +1,366 @@
+#ifndef ESCAPETOKENIZER_H
+#define ESCAPETOKENIZER_H
+
+#include "ControlScan.h"
+#include <QChar>
+#include <QtGlobal>
+
+// Shared escape sequence tokenizer for ANSIParser and TerminalEmulator. Splits input
+// into text runs (pointers into the input, never copied), C0 controls, ESC, CSI and
+// string (OSC/DCS/...) sequences. Parameters are accumulated as integers in a fixed
+// array, so tokenizing allocates nothing. The state survives between calls: a
+// sequence cut at the end of one input continues with the next.
+namespace Escape {
+
+inline uint charCode(QChar ch) { return ch.unicode(); }
+inline uint charCode(char ch) { return static_cast<uchar>(ch); }
+inline uint charCode(char16_t ch) { return ch; }
+
+// A complete CSI sequence: ESC [ <private> <params> <intermediate> <final>
+struct CsiCommand {
+    static constexpr int MaxParams = 32;
+    // Larger values are clamped; no mode or coordinate comes close
+    static constexpr int MaxParamValue = 65535;
+
+    char final = 0;
+    char privateMarker = 0;   // '?', '>', '<' or '=' when present
+    char intermediate = 0;    // last intermediate byte (' ', '!', ...), if any
+    int paramCount = 0;       // 0 for "ESC[m"; "ESC[;5H" has two, the first empty
+    int params[MaxParams];    // empty parameters are stored as 0
+
+    bool isPrivate() const { return privateMarker != 0; }
+
+    // Parameter i, or defaultValue when it is missing or 0 (ECMA-48 defaults)
+    int param(int i, int defaultValue) const
+    {
+        return i < paramCount && params[i] != 0 ? params[i] : defaultValue;
+    }
+};
+
+// One decoded SGR attribute. Extended colours (38/48 with ;5;n or ;2;r;g;b) arrive
+// as a single Fg256/FgRgb op instead of three or five raw parameters.
+struct SgrOp {
+    enum Kind {
+        Reset,
+        Bold,
+        Italic,
+        Underline,
+        Inverse,
+        NotBold,
+        NotItalic,
+        NotUnderline,
+        NotInverse,
+        Fg,         // index 0-7, bright adds 8 (30-37, 90-97)
+        Bg,
+        Fg256,      // index 0-255
+        Bg256,
+        FgRgb,
+        BgRgb,
+        FgDefault,
+        BgDefault,
+        Other       // recognised as SGR but not handled; value is the raw code
+    };
+
+    Kind kind = Reset;
+    int value = 0;
+    quint8 r = 0;
+    quint8 g = 0;
+    quint8 b = 0;
+};
+
+// Calls visitor(const SgrOp&) for each attribute of an SGR ('m') command. "ESC[m"
+// is a reset.
+template <typename Visitor>
+void decodeSgr(const CsiCommand& csi, Visitor&& visitor)
+{
+    if (csi.paramCount == 0) {
+        visitor(SgrOp());
+        return;
+    }
+
+    for (int i = 0; i < csi.paramCount; ++i) {
+        const int code = csi.params[i];
+        SgrOp op;
+        op.value = code;
+
+        if (code == 38 || code == 48) {
+            const bool fg = code == 38;
+            if (i + 2 < csi.paramCount && csi.params[i + 1] == 5) {
+                op.kind = fg ? SgrOp::Fg256 : SgrOp::Bg256;
+                op.value = qMin(csi.params[i + 2], 255);
+                i += 2;
+            } else if (i + 4 < csi.paramCount && csi.params[i + 1] == 2) {
+                op.kind = fg ? SgrOp::FgRgb : SgrOp::BgRgb;
+                op.r = static_cast<quint8>(qMin(csi.params[i + 2], 255));
+                op.g = static_cast<quint8>(qMin(csi.params[i + 3], 255));
+                op.b = static_cast<quint8>(qMin(csi.params[i + 4], 255));
+                i += 4;
+            } else {
+                continue;
+            }
+        } else if (code >= 30 && code <= 37) {
+            op.kind = SgrOp::Fg;
+            op.value = code - 30;
+        } else if (code >= 40 && code <= 47) {
+            op.kind = SgrOp::Bg;
+            op.value = code - 40;
+        } else if (code >= 90 && code <= 97) {
+            op.kind = SgrOp::Fg;
+            op.value = code - 90 + 8;
+        } else if (code >= 100 && code <= 107) {
+            op.kind = SgrOp::Bg;
+            op.value = code - 100 + 8;
+        } else {
+            switch (code) {
+            case 0: op.kind = SgrOp::Reset; break;
+            case 1: op.kind = SgrOp::Bold; break;
+            case 3: op.kind = SgrOp::Italic; break;
+            case 4: op.kind = SgrOp::Underline; break;
+            case 7: op.kind = SgrOp::Inverse; break;
+            case 22: op.kind = SgrOp::NotBold; break;
+            case 23: op.kind = SgrOp::NotItalic; break;
+            case 24: op.kind = SgrOp::NotUnderline; break;
+            case 27: op.kind = SgrOp::NotInverse; break;
+            case 39: op.kind = SgrOp::FgDefault; break;
+            case 49: op.kind = SgrOp::BgDefault; break;
+            default: op.kind = SgrOp::Other; break;
+            }
+        }
+        visitor(op);
+    }
+}
+
+template <typename CharT>
+class Tokenizer {
+public:
+    enum class TokenType {
+        Text,       // printable run: text/length point into the input
+        Control,    // C0 control or DEL in code; text points at it
+        Esc,        // two-character escape (or with one intermediate, e.g. ESC ( B)
+        Csi,        // csi points at the tokenizer's command, valid until the next call
+        String      // OSC, DCS, SOS, PM or APC; the payload is skipped
+    };
+
+    struct Token {
+        TokenType type = TokenType::Text;
+        const CharT* text = nullptr;
+        int length = 0;
+        uint code = 0;             // Control: the character; Esc/String: final/introducer
+        uint intermediate = 0;     // Esc: the intermediate byte, if any
+        const CsiCommand* csi = nullptr;
+    };
+
+    Tokenizer() { reset(); }
+
+    void reset()
+    {
+        m_state = State::Ground;
+        m_escIntermediate = 0;
+        m_stringIntroducer = 0;
+        beginCsi();
+    }
+
+    // True while a sequence is open, i.e. the last input ended inside one
+    bool inSequence() const { return m_state != State::Ground; }
+
+    // Produces the next token from [pos, end) and advances pos past it. Returns false
+    // when the input is used up; a partial sequence is kept for the next input.
+    bool next(const CharT*& pos, const CharT* end, Token& token)
+    {
+        while (pos < end) {
+            const uint ch = charCode(*pos);
+
+            switch (m_state) {
+            case State::Ground: {
+                if (isText(ch)) {
+                    // Printable runs are most of the input; find their end in bulk
+                    const CharT* start = pos;
+                    pos = findControl(pos + 1, end);
+                    token.type = TokenType::Text;
+                    token.text = start;
+                    token.length = static_cast<int>(pos - start);
+                    return true;
+                }
+                ++pos;
+                if (ch == 0x1b) {
+                    m_state = State::Escape;
+                    continue;
+                }
+                return control(pos, token);
+            }
+
+            case State::Escape:
+                ++pos;
+                if (ch == '[') {
+                    beginCsi();
+                    m_state = State::CsiParam;
+                } else if (ch == ']' || ch == 'P' || ch == 'X' || ch == '^' || ch == '_') {
+                    m_stringIntroducer = ch;
+                    m_state = State::String;
+                } else if (ch >= 0x20 && ch <= 0x2f) {
+                    m_escIntermediate = ch;
+                    m_state = State::EscapeIntermediate;
+                } else if (ch == 0x1b) {
+                    // ESC ESC: start over
+                } else if (ch < 0x20) {
+                    // Controls execute in the middle of a sequence
+                    return control(pos, token);
+                } else {
+                    m_state = State::Ground;
+                    token.type = TokenType::Esc;
+                    token.code = ch;
+                    token.intermediate = 0;
+                    return true;
+                }
+                continue;
+
+            case State::EscapeIntermediate:
+                ++pos;
+                if (ch == 0x1b) {
+                    m_state = State::Escape;
+                } else if (ch < 0x20) {
+                    return control(pos, token);
+                } else if (ch <= 0x2f) {
+                    m_escIntermediate = ch;
+                } else {
+                    m_state = State::Ground;
+                    token.type = TokenType::Esc;
+                    token.code = ch;
+                    token.intermediate = m_escIntermediate;
+                    return true;
+                }
+                continue;
+
+            case State::CsiParam:
+                ++pos;
+                if (ch >= '0' && ch <= '9') {
+                    addDigit(static_cast<int>(ch - '0'));
+                } else if (ch == ';' || ch == ':') {
+                    nextParam();
+                } else if (ch >= 0x3c && ch <= 0x3f) {
+                    // Private marker; only meaningful before the first parameter
+                    if (m_csi.paramCount == 0 && m_csi.privateMarker == 0) {
+                        m_csi.privateMarker = static_cast<char>(ch);
+                    }
+                } else if (ch >= 0x20 && ch <= 0x2f) {
+                    m_csi.intermediate = static_cast<char>(ch);
+                } else if (ch >= 0x40 && ch <= 0x7e) {
+                    m_state = State::Ground;
+                    m_csi.final = static_cast<char>(ch);
+                    token.type = TokenType::Csi;
+                    token.csi = &m_csi;
+                    return true;
+                } else if (ch == 0x1b) {
+                    m_state = State::Escape;
+                } else if (ch == 0x18 || ch == 0x1a) {
+                    // CAN/SUB abort the sequence
+                    m_state = State::Ground;
+                } else if (ch < 0x20) {
+                    return control(pos, token);
+                } else {
+                    // Not valid inside CSI: drop the sequence
+                    m_state = State::Ground;
+                }
+                continue;
+
+            case State::String:
+                ++pos;
+                if (ch == 0x07 && m_stringIntroducer == ']') {
+                    return finishString(token);
+                } else if (ch == 0x1b) {
+                    m_state = State::StringEscape;
+                } else if (ch == 0x18 || ch == 0x1a) {
+                    m_state = State::Ground;
+                }
+                continue;
+
+            case State::StringEscape:
+                if (ch == '\\') {
+                    ++pos;
+                    return finishString(token);
+                }
+                // Any other ESC sequence ends the string and is then processed as usual
+                finishString(token);
+                m_state = State::Escape;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    enum class State {
+        Ground,
+        Escape,
+        EscapeIntermediate,
+        CsiParam,
+        String,
+        StringEscape
+    };
+
+    // Everything except C0 controls, ESC and DEL
+    static bool isText(uint ch) { return ch >= 0x20 && ch != 0x7f; }
+
+    void beginCsi()
+    {
+        m_csi.final = 0;
+        m_csi.privateMarker = 0;
+        m_csi.intermediate = 0;
+        m_csi.paramCount = 0;
+        m_paramOverflow = false;
+    }
+
+    void addDigit(int digit)
+    {
+        if (m_paramOverflow) {
+            return;
+        }
+        if (m_csi.paramCount == 0) {
+            m_csi.params[0] = 0;
+            m_csi.paramCount = 1;
+        }
+        int& value = m_csi.params[m_csi.paramCount - 1];
+        value = qMin(value * 10 + digit, CsiCommand::MaxParamValue);
+    }
+
+    void nextParam()
+    {
+        if (m_csi.paramCount == 0) {
+            m_csi.params[0] = 0;
+            m_csi.paramCount = 1;
+        }
+        if (m_csi.paramCount == CsiCommand::MaxParams) {
+            m_paramOverflow = true;
+            return;
+        }
+        m_csi.params[m_csi.paramCount++] = 0;
+    }
+
+    // pos has already moved past the control character
+    static bool control(const CharT* pos, Token& token)
+    {
+        token.type = TokenType::Control;
+        token.text = pos - 1;
+        token.length = 1;
+        token.code = charCode(pos[-1]);
+        return true;
+    }
+
+    bool finishString(Token& token)
+    {
+        m_state = State::Ground;
+        token.type = TokenType::String;
+        token.code = m_stringIntroducer;
+        return true;
+    }
+
+    State m_state;
+    uint m_escIntermediate;
+    uint m_stringIntroducer;
+    bool m_paramOverflow;
+    CsiCommand m_csi;
+};
+
+} // namespace Escape
+
+#endif // ESCAPETOKENIZER_H
@@ -0,0 +1,64 @@
+#ifndef GLYPHCACHE_H
+#define GLYPHCACHE_H
+
+#include <QCache>
+#include <QFont>
+#include <QGlyphRun>
+#include <QList>
+#include <QString>
+
+// Shaped glyphs for runs of terminal text, so content that is painted again and again
+// (prompts, status lines, rows that did not change) goes through the shaper once.
+//
+// Text is split into clusters the way TerminalScreen lays it out: a character and the
+// zero-width marks after it, taking Unicode::charWidth() columns. Clusters are shaped
+// with QTextLayout (HarfBuzz), so combining marks stack and fallback fonts are found,
+// and the glyphs are placed on the cell grid. Results are kept in LRU caches keyed by
+// the text and its style.
+class GlyphCache {
+public:
+    enum StyleFlag {
+        Bold = 0x1,
+        Italic = 0x2,
+        Underline = 0x4
+    };
+
+    // Entries in each cache: whole runs and single clusters
+    static constexpr int RunCapacity = 4096;
+    static constexpr int ClusterCapacity = 4096;
+
+    GlyphCache();
+
+    // Clears the caches. cellWidth is the grid pitch; glyph x positions are scaled
+    // from the font's advance to it.
+    void setFont(const QFont& font, int cellWidth);
+
+    // With ligatures on, runs of single-column characters are shaped together, so a
+    // programming font can join "->" or "!=". Off (the default), every cluster is
+    // shaped on its own and nothing is joined.
+    void setLigaturesEnabled(bool enabled);
+    bool ligaturesEnabled() const { return m_ligatures; }
+
+    // Glyphs for text drawn with the given StyleFlags. Positions are relative to the
+    // left edge of the first cell and the baseline.
+    QList<QGlyphRun> glyphs(const QString& text, int style);
+
+    void clear();
+
+private:
+    QList<QGlyphRun> shapeRun(const QString& text, int style);
+    QList<QGlyphRun> shapeCluster(const QString& text, int style);
+    QList<QGlyphRun> layoutText(const QString& text, int style) const;
+    QFont fontFor(int style) const;
+
+    QFont m_font;
+    qreal m_scale;
+    int m_cellWidth;
+    bool m_ligatures;
+
+    // Keys are the style as one character followed by the text
+    QCache<QString, QList<QGlyphRun>> m_runs;
+    QCache<QString, QList<QGlyphRun>> m_clusters;
+};
+
+#endif // GLYPHCACHE_H
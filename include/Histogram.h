@@ -0,0 +1,48 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <QAtomicInteger>
+#include <QJsonObject>
+#include <QtGlobal>
+#include <array>
+
+// Lock-free log-linear histogram in the spirit of HdrHistogram. Values are bucketed
+// by power of two, each power split into 32 linear sub-buckets, so any recorded value
+// is reported within ~3% of its true value. record() is wait-free and may be called
+// from any thread; readers see a consistent-enough snapshot for monitoring.
+class Histogram {
+public:
+    static constexpr int SubBucketBits = 5;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int MagnitudeCount = 40;
+    static constexpr int BucketCount = SubBucketCount * MagnitudeCount;
+
+    Histogram();
+
+    void record(quint64 value);
+    void reset();
+
+    quint64 count() const { return m_count.loadRelaxed(); }
+    quint64 min() const;
+    quint64 max() const { return m_max.loadRelaxed(); }
+    double mean() const;
+
+    // Smallest bucket value at or above the given percentile (0-100)
+    quint64 percentile(double percent) const;
+
+    // count, min, max, mean and common percentiles, each divided by `divisor`
+    // (e.g. 1e6 to report nanoseconds as milliseconds)
+    QJsonObject toJson(double divisor = 1.0) const;
+
+    static int bucketIndex(quint64 value);
+    static quint64 bucketUpperBound(int index);
+
+private:
+    std::array<QAtomicInteger<quint64>, BucketCount> m_buckets;
+    QAtomicInteger<quint64> m_count;
+    QAtomicInteger<quint64> m_sum;
+    QAtomicInteger<quint64> m_min;
+    QAtomicInteger<quint64> m_max;
+};
+
+#endif // HISTOGRAM_H
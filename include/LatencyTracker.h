@@ -0,0 +1,62 @@
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include "Histogram.h"
+#include <QAtomicInteger>
+#include <QJsonObject>
+
+// Keystroke-to-photon latency for one session. A probe starts at a key press and is
+// followed through the pipeline: written to the transport (session thread), first
+// bytes read back (session thread), applied to the emulator (GUI) and painted (GUI).
+// Only one probe is in flight at a time, so typing bursts sample rather than queue.
+// All mark*() calls are lock-free and safe from any thread.
+class LatencyTracker {
+public:
+    enum Segment {
+        KeyToWrite,
+        WriteToEcho,
+        EchoToApply,
+        ApplyToPaint,
+        KeyToPaint,
+        SegmentCount
+    };
+
+    // A probe that has not completed by then (no echo, e.g. at a password prompt) is
+    // dropped when the next key is pressed
+    static constexpr quint64 ProbeTimeoutNs = 2000000000ULL;
+
+    LatencyTracker();
+
+    void markKeyPress();
+    void markWrite();
+    void markEcho();
+    void markApplied();
+    void markPainted();
+
+    const Histogram& histogram(Segment segment) const { return m_histograms[segment]; }
+    quint64 completedProbes() const { return m_completed.loadRelaxed(); }
+    quint64 abandonedProbes() const { return m_abandoned.loadRelaxed(); }
+    void reset();
+
+    // Per-segment statistics in milliseconds
+    QJsonObject toJson() const;
+
+    static const char* segmentName(Segment segment);
+    static quint64 now();
+
+private:
+    enum Stage { Idle, KeyPressed, Written, Echoed, Applied };
+
+    bool advance(Stage from, Stage to);
+
+    QAtomicInteger<int> m_stage;
+    QAtomicInteger<quint64> m_keyPressNs;
+    QAtomicInteger<quint64> m_writeNs;
+    QAtomicInteger<quint64> m_echoNs;
+    QAtomicInteger<quint64> m_appliedNs;
+    QAtomicInteger<quint64> m_completed;
+    QAtomicInteger<quint64> m_abandoned;
+    Histogram m_histograms[SegmentCount];
+};
+
+#endif // LATENCYTRACKER_H
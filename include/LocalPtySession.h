@@ -0,0 +1,47 @@
+#ifndef LOCALPTYSESSION_H
+#define LOCALPTYSESSION_H
+
+#include "TerminalSession.h"
+#include <QString>
+#include <QStringList>
+
+// Terminal session backed by a local pseudo-terminal. The child process is started
+// with forkpty() and this thread reads its output, so the emulator and view can be
+// exercised end to end (cat, yes, vim, ...) without a network or an SSH server.
+class LocalPtySession : public TerminalSession {
+    Q_OBJECT
+
+public:
+    // An empty program starts the user's shell ($SHELL, falling back to /bin/sh)
+    explicit LocalPtySession(const QString& program = QString(),
+                             const QStringList& arguments = QStringList(),
+                             QObject* parent = nullptr);
+    ~LocalPtySession();
+
+    QString program() const { return m_program; }
+    qint64 processId() const { return m_childPid; }
+    int exitStatus() const { return m_exitStatus; }
+
+    static bool isSupported();
+
+protected:
+    void run() override;
+    void interruptIo() override;
+
+private:
+    bool startChild(int rows, int cols);
+    bool readOutput();
+    void processWriteQueue();
+    void processResize();
+    void cleanup();
+
+    QString m_program;
+    QStringList m_arguments;
+    QByteArray m_pendingWrite;
+    int m_masterFd;
+    int m_wakePipe[2];
+    qint64 m_childPid;
+    int m_exitStatus;
+};
+
+#endif // LOCALPTYSESSION_H
@@ -1,10 +1,18 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include "BinaryLog.h"
+#include "MappedLogFile.h"
+#include "MpscRing.h"
+#include <QAtomicInteger>
+#include <QHash>
+#include <QSet>
 #include <QLoggingCategory>
 #include <QString>
 #include <QFile>
 #include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
 
 // Logging categories
 Q_DECLARE_LOGGING_CATEGORY(sshConnection)
@@ -12,19 +20,65 @@ Q_DECLARE_LOGGING_CATEGORY(sshAuth)
 Q_DECLARE_LOGGING_CATEGORY(terminal)
 Q_DECLARE_LOGGING_CATEGORY(ui)
 Q_DECLARE_LOGGING_CATEGORY(storage)
+Q_DECLARE_LOGGING_CATEGORY(metrics)
 
+// Application log. Logging threads only push a record into a lock-free ring; a
+// background writer thread formats, batches, writes and rotates. When the ring is full
+// records are dropped and counted rather than blocking the caller (e.g. an I/O thread).
 class Logger {
 public:
+    // Records buffered between the logging threads and the writer
+    static constexpr int QueueCapacity = 8192;
+
     static Logger& instance();
 
     void initialize();
     void setupFileLogging(const QString& logPath = QString());
+
+    // Binary mode writes compact records to a memory-mapped .blog file instead of text
+    // (decode with blog-decode). Choose it before initialize().
+    void setBinaryMode(bool enabled);
+    bool isBinaryMode() const { return m_binaryMode; }
+
+    // Backend of the SLOG_* macros: arguments arrive encoded and are only rendered to
+    // text in text mode
+    void logStructured(const char* category, QtMsgType type, quint32 formatId,
+                       QByteArray&& args);
+
     void setMaxFileSize(qint64 maxSize);
     void setMaxFiles(int maxFiles);
 
     QString logFilePath() const;
 
+    // Blocks until everything logged so far is written, or the timeout expires
+    bool flush(int timeoutMs = 2000);
+    // Drains and stops the writer thread; later messages are written synchronously
+    void shutdown();
+
+    quint64 droppedRecords() const { return m_dropped.loadRelaxed(); }
+
 private:
+    struct Record {
+        quint64 timestampUs = 0;
+        QtMsgType type = QtDebugMsg;
+        char category[32] = {};
+        // Plain messages carry text; structured ones a format id and encoded arguments
+        QString message;
+        quint32 formatId = 0;
+        QByteArray args;
+    };
+
+    class Writer : public QThread {
+    public:
+        explicit Writer(Logger* logger) : m_logger(logger) {}
+
+    protected:
+        void run() override;
+
+    private:
+        Logger* m_logger;
+    };
+
     Logger();
     ~Logger();
     Logger(const Logger&) = delete;
@@ -32,15 +86,66 @@ private:
 
     static void messageHandler(QtMsgType type, const QMessageLogContext& context,
                                 const QString& msg);
+    static QString messageText(const Record& record);
+
+    void submit(Record&& record);
+    void enqueue(Record&& record);
+    void wakeWriter();
+    bool drainQueue();
+    void writeRecord(const Record& record);
+    void writeBinaryRecord(const Record& record);
+    QByteArray encodeBinaryRecord(const Record& record);
+    void openBinaryFile();
     void rotateLogFiles();
     QString getLogFileName(int index = 0) const;
 
     QFile m_logFile;
     QString m_logPath;
+    bool m_binaryMode;
+
+    // Binary mode output; ids are per file so each file decodes on its own
+    MappedLogFile m_binaryFile;
+    QHash<QByteArray, quint16> m_categoryIds;
+    QSet<quint32> m_definedFormats;
+    // When the binary file cannot be opened, records are dropped until the next attempt
+    quint64 m_binaryRetryAtUs;
+    int m_binaryRetryDelayMs;
     qint64 m_maxFileSize;
     int m_maxFiles;
+
+    // Guards the file and the consuming end of the ring; taken by the writer and by
+    // configuration calls, and by loggers only once the writer has stopped
     QMutex m_mutex;
+
+    MpscRing<Record> m_queue;
+    QAtomicInteger<quint64> m_dropped;
+    quint64 m_reportedDropped;
+
+    Writer* m_writer;
+    QAtomicInt m_writerRunning;
+    QAtomicInt m_writerIdle;
+    QAtomicInt m_stopRequested;
+    QMutex m_wakeMutex;
+    QWaitCondition m_wakeCondition;
+
     static Logger* s_instance;
 };
 
+// Structured logging: SLOG_DEBUG(sshConnection, "Read %1 bytes", n). The format must
+// be a string literal; arguments are integers, floating point or strings. Disabled
+// categories cost one check, and in binary mode nothing is formatted at all.
+#define SLOG(category, level, ...)                                                    \
+    do {                                                                              \
+        if (category().isEnabled(level)) {                                            \
+            static const quint32 slogFormatId = BinaryLog::registerFormat(__VA_ARGS__); \
+            Logger::instance().logStructured(category().categoryName(), level,        \
+                                             slogFormatId,                            \
+                                             BinaryLog::encodeArgs(__VA_ARGS__));      \
+        }                                                                             \
+    } while (0)
+
+#define SLOG_DEBUG(category, ...) SLOG(category, QtDebugMsg, __VA_ARGS__)
+#define SLOG_INFO(category, ...) SLOG(category, QtInfoMsg, __VA_ARGS__)
+#define SLOG_WARNING(category, ...) SLOG(category, QtWarningMsg, __VA_ARGS__)
+
 #endif // LOGGER_H
@@ -7,10 +7,13 @@
 #include <QMainWindow>
 #include <QTabWidget>
 #include <QAction>
+#include <QActionGroup>
 #include <QListWidget>
 
 class SSHConnection;
-class SSHWorkerThread;
+class TerminalSession;
+class LatencyTracker;
+struct SessionMetrics;
 class ConnectionDialog;
 
 class MainWindow : public QMainWindow {
@@ -24,6 +27,8 @@ public:
     void addNewTab(const QString& title);
     void closeCurrentTab();
     TerminalView* currentTerminal();
+    void openLocalTerminal(const QString& program = QString(),
+                           const QStringList& arguments = QStringList());
 
     // UI access
     QTabWidget* tabWidget() const;
@@ -36,11 +41,19 @@ signals:
 
 private slots:
     void onNewConnection();
+    void onNewLocalTerminal();
     void onCloseTab();
     void onExit();
     void onCopy();
     void onPaste();
     void onAbout();
+    void onToggleLatencyOverlay(bool visible);
+    void onDumpLatencyStats();
+    void onToggleMetricsOverlay(bool visible);
+    void onDumpMetrics();
+    void onToggleTracing(bool enabled);
+    void onThemeSelected(QAction* action);
+    void onToggleLigatures(bool enabled);
     void onTabCloseRequested(int index);
     void onSavedConnectionClicked(QListWidgetItem* item);
 
@@ -52,15 +65,27 @@ private slots:
     void handleDataReceived(const QByteArray& data);
 
 private:
+    // Connection management
+    struct TabData {
+        TerminalView* terminal;
+        SSHConnection* connection;
+        TerminalSession* worker;
+        LatencyTracker* latency;
+        SessionMetrics* metrics;
+    };
+
     void setupUi();
     void createMenus();
     void createActions();
     void createStatusBar();
     void setupConnections();
+    void attachSession(TabData& tabData, TerminalSession* session);
     void showWelcomeTab();
     void hideWelcomeTab();
     void loadSavedProfiles();
     void saveCurrentProfile(const ConnectionProfile& profile);
+    void releaseInstrumentation(TabData& tabData);
+    QString writeDiagnosticsFile(const QString& prefix, const QByteArray& contents);
 
     // UI components
     QTabWidget* m_tabWidget;
@@ -69,18 +94,22 @@ private:
 
     // Actions
     QAction* m_newConnectionAction;
+    QAction* m_newLocalTerminalAction;
     QAction* m_closeTabAction;
     QAction* m_exitAction;
     QAction* m_copyAction;
     QAction* m_pasteAction;
     QAction* m_aboutAction;
-
-    // Connection management
-    struct TabData {
-        TerminalView* terminal;
-        SSHConnection* connection;
-        SSHWorkerThread* worker;
-    };
+    QAction* m_latencyOverlayAction;
+    QAction* m_dumpLatencyAction;
+    QAction* m_metricsOverlayAction;
+    QAction* m_dumpMetricsAction;
+    QAction* m_traceAction;
+    QActionGroup* m_themeGroup;
+    QAction* m_ligaturesAction;
+
+    // Applied to every tab and to new ones; points into ColorTheme::available()
+    const ColorTheme* m_theme;
 
     QList<TabData> m_tabs;
     ProfileStorage* m_profileStorage;
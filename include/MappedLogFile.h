@@ -0,0 +1,42 @@
+#ifndef MAPPEDLOGFILE_H
+#define MAPPEDLOGFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+// Fixed-size log segment written through a memory mapping. The file is sized up front
+// and mapped once, so appending is a memcpy; pages written before a crash still reach
+// the disk because the kernel owns them. close() trims the file to what was written.
+// Not thread-safe: Logger's writer thread is the only user.
+class MappedLogFile {
+public:
+    static constexpr qint64 DefaultSegmentSize = 16 * 1024 * 1024;
+
+    MappedLogFile();
+    ~MappedLogFile();
+
+    MappedLogFile(const MappedLogFile&) = delete;
+    MappedLogFile& operator=(const MappedLogFile&) = delete;
+
+    // Creates (or truncates) `path`, sizes it to `segmentSize` and writes `header`
+    bool open(const QString& path, const QByteArray& header,
+              qint64 segmentSize = DefaultSegmentSize);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    // False when the data does not fit in what is left of the segment
+    bool append(const QByteArray& data);
+
+    qint64 size() const { return m_used; }
+    qint64 capacity() const { return m_capacity; }
+    QString errorString() const { return m_file.errorString(); }
+
+private:
+    QFile m_file;
+    uchar* m_data;
+    qint64 m_capacity;
+    qint64 m_used;
+};
+
+#endif // MAPPEDLOGFILE_H
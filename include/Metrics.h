@@ -0,0 +1,85 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "Histogram.h"
+#include <QAtomicInteger>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+// Monotonic event or byte count. Relaxed atomics: updates never synchronise with
+// anything, so instrumenting a hot path costs one uncontended add.
+class Counter {
+public:
+    Counter() : m_value(0) {}
+
+    void add(quint64 amount = 1) { m_value.fetchAndAddRelaxed(amount); }
+    quint64 value() const { return m_value.loadRelaxed(); }
+    void reset() { m_value.storeRelaxed(0); }
+
+private:
+    QAtomicInteger<quint64> m_value;
+};
+
+// Last observed level of something that goes up and down (queue depth, memory)
+class Gauge {
+public:
+    Gauge() : m_value(0) {}
+
+    void set(qint64 value) { m_value.storeRelaxed(value); }
+    void add(qint64 delta) { m_value.fetchAndAddRelaxed(delta); }
+    qint64 value() const { return m_value.loadRelaxed(); }
+
+private:
+    QAtomicInteger<qint64> m_value;
+};
+
+// Instruments for one terminal session. The session thread updates the transport
+// side, the GUI thread the emulator and paint side; anyone may read at any time.
+struct SessionMetrics {
+    explicit SessionMetrics(const QString& sessionName) : name(sessionName) {}
+
+    QString name;
+
+    // Transport (session thread)
+    Counter bytesIn;
+    Counter bytesOut;
+    Counter readCalls;
+    Counter writeCalls;
+    Gauge writeQueueDepth;
+    Gauge inboundPendingBytes;
+
+    // Emulator and view (GUI thread), times in nanoseconds
+    Histogram parseTimeNs;
+    Histogram paintTimeNs;
+    Counter framesRendered;
+    Counter framesSkipped;
+    Gauge scrollbackBytes;
+
+    QJsonObject toJson() const;
+};
+
+// Process-wide list of live sessions for dumps. Registration takes a lock; updating
+// the instruments themselves never does.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    void add(SessionMetrics* metrics);
+    void remove(SessionMetrics* metrics);
+    int sessionCount() const;
+
+    // {"timestamp": ..., "sessions": [...]}
+    QJsonObject toJson() const;
+
+private:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    mutable QMutex m_mutex;
+    QList<SessionMetrics*> m_sessions;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,100 @@
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#include <QAtomicInteger>
+#include <QtGlobal>
+#include <memory>
+#include <utility>
+
+// Bounded multi-producer, single-consumer queue (D. Vyukov's sequence-numbered ring).
+// tryPush() is lock-free and fails instead of blocking when the ring is full, so the
+// caller decides what to drop. tryPop() must only be called from one thread.
+template <typename T>
+class MpscRing {
+public:
+    // Capacity is rounded up to a power of two
+    explicit MpscRing(quint64 capacity)
+        : m_capacity(roundUp(capacity)), m_mask(m_capacity - 1),
+          m_slots(new Slot[m_capacity]), m_enqueuePos(0), m_dequeuePos(0)
+    {
+        for (quint64 i = 0; i < m_capacity; ++i) {
+            m_slots[i].sequence.storeRelaxed(i);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    bool tryPush(T&& value)
+    {
+        quint64 pos = m_enqueuePos.loadRelaxed();
+        Slot* slot = nullptr;
+        while (true) {
+            slot = &m_slots[pos & m_mask];
+            quint64 sequence = slot->sequence.loadAcquire();
+            qint64 diff = static_cast<qint64>(sequence - pos);
+            if (diff == 0) {
+                // Slot is free for this ticket; claim the ticket
+                if (m_enqueuePos.testAndSetRelaxed(pos, pos + 1, pos)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // The consumer has not released this slot yet: full
+                return false;
+            } else {
+                pos = m_enqueuePos.loadRelaxed();
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.storeRelease(pos + 1);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        Slot& slot = m_slots[m_dequeuePos & m_mask];
+        quint64 sequence = slot.sequence.loadAcquire();
+        if (static_cast<qint64>(sequence - (m_dequeuePos + 1)) < 0) {
+            return false;
+        }
+
+        value = std::move(slot.value);
+        slot.sequence.storeRelease(m_dequeuePos + m_capacity);
+        ++m_dequeuePos;
+        return true;
+    }
+
+    quint64 capacity() const { return m_capacity; }
+
+    // Tickets handed out so far; with consumed() this tells a flush when it has caught up
+    quint64 pushed() const { return m_enqueuePos.loadAcquire(); }
+    quint64 consumed() const { return m_consumed.loadAcquire(); }
+
+    // Called by the consumer once popped values have been fully handled
+    void markConsumed() { m_consumed.storeRelease(m_dequeuePos); }
+
+private:
+    struct Slot {
+        QAtomicInteger<quint64> sequence;
+        T value;
+    };
+
+    static quint64 roundUp(quint64 value)
+    {
+        quint64 capacity = 2;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    const quint64 m_capacity;
+    const quint64 m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    QAtomicInteger<quint64> m_enqueuePos;
+    quint64 m_dequeuePos;
+    QAtomicInteger<quint64> m_consumed{0};
+};
+
+#endif // MPSCRING_H
@@ -21,6 +21,7 @@ public:
     // Shell operations
     bool requestShell();
     bool requestPty(int rows = 24, int cols = 80, const QString& termType = "xterm-256color");
+    bool changePtySize(int rows, int cols);
 
     // I/O operations
     int write(const QString& data);
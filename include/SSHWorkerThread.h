@@ -3,47 +3,27 @@
 
 #include "SSHConnection.h"
 #include "SSHChannel.h"
-#include <QThread>
-#include <QMutex>
-#include <QQueue>
-#include <QWaitCondition>
-#include <QByteArray>
+#include "TerminalSession.h"
 
-class SSHWorkerThread : public QThread {
+class SSHWorkerThread : public TerminalSession {
     Q_OBJECT
 
 public:
     explicit SSHWorkerThread(SSHConnection* connection, QObject* parent = nullptr);
     ~SSHWorkerThread();
 
-    // Thread control
-    void stop();
-
-    // Data transmission
-    void writeData(const QString& data);
-    void writeData(const QByteArray& data);
-
-signals:
-    void dataReceived(const QByteArray& data);
-    void error(const QString& message);
-    void disconnected();
-
 protected:
     void run() override;
 
 private:
-    void readLoop();
+    bool readLoop();
     void processWriteQueue();
+    void processResize();
     bool initializeChannel();
     void cleanup();
 
     SSHConnection* m_connection;
     SSHChannel* m_channel;
-    QMutex m_mutex;
-    QQueue<QByteArray> m_writeQueue;
-    QWaitCondition m_writeCondition;
-    bool m_stopRequested;
-    bool m_running;
 };
 
 #endif // SSHWORKERTHREAD_H
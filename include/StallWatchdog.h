@@ -0,0 +1,68 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QAtomicInteger>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+// Detects GUI thread stalls. A background thread posts a ping to the GUI event loop
+// and waits for it to be handled; once a ping is older than the threshold it samples
+// the pipeline phase the GUI thread is in (Tracer::currentPhase, which knows the phases
+// other than Connect only while a trace is recorded) and, where supported, a backtrace
+// of the GUI thread. When the event loop recovers a JSON report with the
+// stall duration is written to the report directory (the log directory by default).
+//
+// Construct on the GUI thread.
+class StallWatchdog : public QThread {
+public:
+    static constexpr int DefaultThresholdMs = 500;
+    // Reports written per run; later stalls are only logged
+    static constexpr int MaxReports = 20;
+
+    explicit StallWatchdog(QObject* parent = nullptr);
+    ~StallWatchdog() override;
+
+    StallWatchdog(const StallWatchdog&) = delete;
+    StallWatchdog& operator=(const StallWatchdog&) = delete;
+
+    void setThresholdMs(int thresholdMs);
+    int thresholdMs() const { return m_thresholdMs; }
+
+    void setReportDirectory(const QString& directory);
+    QString reportDirectory() const { return m_reportDirectory; }
+
+    // Stops the thread; safe to call more than once
+    void stop();
+
+    quint64 stallCount() const { return m_stallCount.loadRelaxed(); }
+
+protected:
+    void run() override;
+
+private:
+    struct Stall {
+        qint64 durationMs = 0;
+        QString phase;
+        QStringList backtrace;
+        QString backtraceNote;
+    };
+
+    void ping(quint64 sequence);
+    void sample(Stall& stall);
+    QString writeReport(const Stall& stall);
+
+    // Lives on the GUI thread; pings queued to it are discarded once it is destroyed
+    QObject m_guiContext;
+    Qt::HANDLE m_guiThreadId;
+
+    int m_thresholdMs;
+    QString m_reportDirectory;
+    int m_reportsWritten;
+
+    QAtomicInteger<quint64> m_acknowledged;
+    QAtomicInteger<quint64> m_stallCount;
+};
+
+#endif // STALLWATCHDOG_H
@@ -4,8 +4,68 @@
 #include <QString>
 #include <QVector>
 
+// Line history with a fixed capacity (the scrollback limit). Lines live in a ring:
+// storage grows until it reaches the limit, after which each appended line replaces
+// the oldest one in place, so appending is O(1) however much history is kept.
+// Indexes are logical, 0 being the oldest line still held.
 class TerminalBuffer {
 public:
+    // Non-owning view over consecutive lines, valid until the buffer is next modified.
+    // The lines may straddle the ring's wrap point, so storage is exposed as up to two
+    // contiguous segments.
+    class LineRange {
+    public:
+        struct Segment {
+            const QString* data = nullptr;
+            int size = 0;
+        };
+
+        class const_iterator {
+        public:
+            const QString& operator*() const { return m_range->at(m_index); }
+            const QString* operator->() const { return &m_range->at(m_index); }
+            const_iterator& operator++()
+            {
+                ++m_index;
+                return *this;
+            }
+            bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+            bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+        private:
+            friend class LineRange;
+            const_iterator(const LineRange* range, int index) : m_range(range), m_index(index) {}
+
+            const LineRange* m_range;
+            int m_index;
+        };
+
+        int size() const { return m_count; }
+        bool isEmpty() const { return m_count == 0; }
+        // Logical index in the buffer of the first line in the range
+        int firstIndex() const { return m_first; }
+
+        const QString& at(int i) const { return m_buffer->lineAt(m_first + i); }
+        const QString& operator[](int i) const { return at(i); }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_count); }
+
+        Segment firstSegment() const;
+        Segment secondSegment() const;
+
+    private:
+        friend class TerminalBuffer;
+        LineRange(const TerminalBuffer* buffer, int first, int count)
+            : m_buffer(buffer), m_first(first), m_count(count)
+        {
+        }
+
+        const TerminalBuffer* m_buffer;
+        int m_first;
+        int m_count;
+    };
+
     // Constructors
     TerminalBuffer();
     TerminalBuffer(int rows, int columns);
@@ -18,8 +78,30 @@ public:
     // Buffer operations
     void appendLine(const QString& line);
     QString getLine(int index) const;
+    // Copies, padded to rows() for getVisibleLines(); prefer the views below
     QVector<QString> getVisibleLines() const;
     QVector<QString> getScrollbackBuffer() const;
+
+    // Views without copying. lineAt() requires 0 <= index < lineCount().
+    const QString& lineAt(int index) const { return m_lines[physicalIndex(index)]; }
+    LineRange lines(int first, int count) const;
+    // Newest rows() lines or fewer, not padded
+    LineRange visibleLines() const;
+    LineRange scrollback() const { return LineRange(this, 0, m_count); }
+
+    // Calls visitor(int index, const QString& line) for each line in [first, first + count)
+    template <typename Visitor>
+    void forEachLine(int first, int count, Visitor&& visitor) const
+    {
+        LineRange range = lines(first, count);
+        int index = range.firstIndex();
+        for (LineRange::Segment segment : {range.firstSegment(), range.secondSegment()}) {
+            for (int i = 0; i < segment.size; ++i) {
+                visitor(index++, segment.data[i]);
+            }
+        }
+    }
+
     void clear();
     bool isEmpty() const;
     int lineCount() const;
@@ -52,10 +134,14 @@ private:
         SelectionRange() : startRow(0), startColumn(0), endRow(0), endColumn(0), active(false) {}
     };
 
-    void enforceScrollbackLimit();
+    void pushLine(const QString& line);
+    // Storage slot of logical line `index`
+    int physicalIndex(int index) const { return (m_head + index) % m_lines.size(); }
     QString wrapLine(const QString& line, int offset = 0);
 
-    QVector<QString> m_buffer;
+    QVector<QString> m_lines;
+    int m_head;  // slot of the oldest line once the ring is full, otherwise 0
+    int m_count;
     int m_rows;
     int m_columns;
     int m_maxScrollback;
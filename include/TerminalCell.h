@@ -0,0 +1,122 @@
+#ifndef TERMINALCELL_H
+#define TERMINALCELL_H
+
+#include "ColorPalette.h"
+#include <QString>
+#include <QHash>
+#include <QVector>
+
+class ClusterTable;
+
+struct TerminalCell {
+    // Code points above the Unicode range are cluster ids: a character followed by
+    // combining marks, whose text is kept in the screen's ClusterTable
+    static constexpr char32_t ClusterBase = 0x110000;
+
+    // A Unicode code point or a cluster id
+    char32_t character = ' ';
+    TerminalColor fgColor = TerminalColor::defaultForeground();
+    TerminalColor bgColor = TerminalColor::defaultBackground();
+    bool bold : 1;
+    bool underline : 1;
+    bool inverse : 1;
+    bool italic : 1;
+    // Columns taken by the character: 2 for the left half of a wide character, 0 for
+    // its right half (and for the padding left when one wraps early), otherwise 1
+    quint8 width : 2;
+
+    TerminalCell() : bold(false), underline(false), inverse(false), italic(false), width(1) {}
+
+    // A blank cell carries no visible content and can be trimmed from line ends. The
+    // right half of a wide character is never blank: trimming it would split the pair.
+    bool isBlank() const
+    {
+        return character == ' ' && width != 0 &&
+               bgColor == TerminalColor::defaultBackground() && !underline && !inverse;
+    }
+
+    bool isCluster() const { return character >= ClusterBase; }
+
+    // Appends the cell's text, looking cluster ids up in the table of the screen the
+    // cell came from; the right half of a wide character adds nothing
+    void appendText(QString& text, const ClusterTable& clusters) const;
+};
+
+static_assert(sizeof(TerminalCell) == 16, "cells are stored by the million in scrollback");
+
+// Text of the clusters stored in one screen and its scrollback. Identical clusters
+// get the same id. Cells are plain values, so ids are not counted; instead, when the
+// table is full its owner marks the ids its cells still hold and sweep() frees the
+// rest for reuse.
+class ClusterTable {
+public:
+    static constexpr int Capacity = 65536;
+
+    // Id for the text, or 0 when all Capacity ids are taken
+    char32_t intern(const QString& text);
+    QString text(char32_t id) const
+    {
+        return m_texts.value(static_cast<int>(id - TerminalCell::ClusterBase));
+    }
+    int size() const { return m_ids.size(); }
+    bool isFull() const { return m_ids.size() >= Capacity; }
+
+    // Reclaiming: mark() every cell still in use, then sweep() frees the ids of
+    // unmarked clusters and returns how many there were
+    void mark(const TerminalCell* cells, int count);
+    int sweep();
+
+private:
+    QVector<QString> m_texts; // by id - ClusterBase; null where the id is free
+    QVector<bool> m_marked;
+    QVector<char32_t> m_free;
+    QHash<QString, char32_t> m_ids;
+};
+
+inline void TerminalCell::appendText(QString& text, const ClusterTable& clusters) const
+{
+    if (width == 0) {
+        return;
+    }
+    if (character < 0x10000) {
+        text += QChar(static_cast<char16_t>(character));
+    } else if (character < ClusterBase) {
+        text += QChar(QChar::highSurrogate(character));
+        text += QChar(QChar::lowSurrogate(character));
+    } else {
+        text += clusters.text(character);
+    }
+}
+
+struct TerminalLine {
+    QVector<TerminalCell> cells;
+    // Set when the line was soft-wrapped, i.e. its text continues on the next row
+    bool wrapped = false;
+
+    // Cells that carry over when the row is joined with the next one: all of them,
+    // less the padding in the last column when a wide character wrapped early
+    int joinedLength() const
+    {
+        const int length = cells.size();
+        if (wrapped && length > 0 && cells[length - 1].width == 0 &&
+            (length == 1 || cells[length - 2].width != 2)) {
+            return length - 1;
+        }
+        return length;
+    }
+
+    // How many of `length` cells go on a row `width` columns wide when a line is
+    // wrapped: up to width, one fewer if the row would end between the halves of a
+    // wide character, which then moves to the next row whole
+    static int rowLength(const TerminalCell* cells, int length, int width)
+    {
+        const int count = length < width ? length : width;
+        if (count > 1 && count < length && cells[count].width == 0 &&
+            cells[count - 1].width == 2) {
+            return count - 1;
+        }
+        return count;
+    }
+};
+
+#endif // TERMINALCELL_H
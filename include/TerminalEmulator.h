@@ -1,15 +1,17 @@
 #ifndef TERMINALEMULATOR_H
 #define TERMINALEMULATOR_H
 
+#include "EscapeTokenizer.h"
 #include "TerminalScreen.h"
+#include "Utf8Decoder.h"
 #include <QString>
-#include <QQueue>
 
 class TerminalEmulator {
 public:
     TerminalEmulator(int rows = 24, int cols = 80);
 
-    // Process incoming data
+    // Process incoming data. Bytes are a UTF-8 stream: a character split across two
+    // calls is held back until the rest of it arrives.
     void processData(const QString& data);
     void processData(const QByteArray& data);
 
@@ -22,29 +24,20 @@ public:
     int rows() const { return m_screen.rows(); }
     int cols() const { return m_screen.cols(); }
 
-private:
-    void processChar(QChar ch);
-    void handleEscapeSequence();
-    void handleCSI();
-    void handleOSC();
+    // Number of escape/control sequences executed since construction
+    quint64 sequenceCount() const { return m_sequenceCount; }
 
-    void executeCsiCommand(QChar command, const QVector<int>& params);
-    QColor getAnsiColor(int colorCode, bool bright = false) const;
-    QColor get256Color(int index) const;
+private:
+    void executeControl(uint code);
+    void executeEscape(uint final, uint intermediate);
+    void executeCsiCommand(const Escape::CsiCommand& csi);
+    void executeSgr(const Escape::CsiCommand& csi);
 
     TerminalScreen m_screen;
-
-    enum class State {
-        Normal,
-        Escape,
-        CSI,
-        OSC,
-        OSC_String
-    };
-
-    State m_state;
-    QString m_escapeBuffer;
-    QString m_oscString;
+    Escape::Tokenizer<QChar> m_tokenizer;
+    Unicode::Utf8Decoder m_utf8;
+    QString m_decoded;
+    quint64 m_sequenceCount;
 };
 
 #endif // TERMINALEMULATOR_H
@@ -1,23 +1,15 @@
 #ifndef TERMINALSCREEN_H
 #define TERMINALSCREEN_H
 
-#include <QColor>
+#include "TerminalCell.h"
+#include "TerminalScrollback.h"
 #include <QVector>
 #include <QString>
 
 class TerminalScreen {
 public:
-    struct Cell {
-        QChar character = ' ';
-        QColor fgColor;
-        QColor bgColor;
-        bool bold = false;
-        bool underline = false;
-        bool inverse = false;
-        bool italic = false;
-
-        Cell() : character(' ') {}
-    };
+    using Cell = TerminalCell;
+    using Line = TerminalLine;
 
     TerminalScreen(int rows = 24, int cols = 80);
 
@@ -36,10 +28,15 @@ public:
     // Cell access
     Cell& cellAt(int row, int col);
     const Cell& cellAt(int row, int col) const;
+    const Line& line(int row) const;
 
     // Text operations
     void putChar(QChar ch);
     void putChar(QChar ch, int row, int col);
+    // A run of printable characters with the current attributes. Surrogate pairs are
+    // decoded, wide characters take two cells and combining marks join the character
+    // before them; non-printable characters are skipped.
+    void putText(const QChar* text, int length);
     void newLine();
     void carriageReturn();
     void backspace();
@@ -60,17 +57,26 @@ public:
     void useNormalBuffer();
     bool isAlternateBuffer() const { return m_useAlternate; }
 
+    // Scrollback (normal buffer only)
+    TerminalScrollback& scrollback() { return m_scrollback; }
+    const TerminalScrollback& scrollback() const { return m_scrollback; }
+    void setMaxScrollback(int lines) { m_scrollback.setMaxLines(lines); }
+    void clearScrollback() { m_scrollback.clear(); }
+
+    // Text of the cluster ids in this screen's cells and scrollback
+    const ClusterTable& clusters() const { return m_clusters; }
+
     // Attributes
-    void setFgColor(const QColor& color) { m_currentFg = color; }
-    void setBgColor(const QColor& color) { m_currentBg = color; }
+    void setFgColor(TerminalColor color) { m_currentFg = color; }
+    void setBgColor(TerminalColor color) { m_currentBg = color; }
     void setBold(bool bold) { m_currentBold = bold; }
     void setUnderline(bool underline) { m_currentUnderline = underline; }
     void setInverse(bool inverse) { m_currentInverse = inverse; }
     void setItalic(bool italic) { m_currentItalic = italic; }
     void resetAttributes();
 
-    QColor currentFg() const { return m_currentFg; }
-    QColor currentBg() const { return m_currentBg; }
+    TerminalColor currentFg() const { return m_currentFg; }
+    TerminalColor currentBg() const { return m_currentBg; }
     bool currentBold() const { return m_currentBold; }
 
     // Scrolling region
@@ -78,8 +84,19 @@ public:
     void resetScrollRegion();
 
 private:
-    void ensureCursorInBounds();
-    void initBuffer(QVector<QVector<Cell>>& buffer);
+    void initBuffer(QVector<Line>& buffer);
+    void clearRow(Line& line, int from = 0, int to = -1);
+    void resizeBuffer(QVector<Line>& buffer, int rows, int cols, int firstRow);
+    void reflowBuffer(QVector<Line>& buffer, int rows, int cols, int& cursorRow, int& cursorCol);
+    static int lastContentRow(const QVector<Line>& buffer);
+
+    Cell styledCell() const;
+    // Cells of the cursor row after any pending scroll or autowrap
+    Cell* cursorRowCells();
+    void putCodePoint(char32_t cp, const Cell& styled);
+    void combine(char32_t mark);
+    void reclaimClusters();
+    void breakWide(Cell* cells, int from, int to) const;
 
     int m_rows;
     int m_cols;
@@ -88,13 +105,15 @@ private:
     bool m_cursorVisible;
 
     // Screen buffers
-    QVector<QVector<Cell>> m_normalBuffer;
-    QVector<QVector<Cell>> m_alternateBuffer;
+    QVector<Line> m_normalBuffer;
+    QVector<Line> m_alternateBuffer;
     bool m_useAlternate;
+    TerminalScrollback m_scrollback;
+    ClusterTable m_clusters;
 
     // Current attributes
-    QColor m_currentFg;
-    QColor m_currentBg;
+    TerminalColor m_currentFg;
+    TerminalColor m_currentBg;
     bool m_currentBold;
     bool m_currentUnderline;
     bool m_currentInverse;
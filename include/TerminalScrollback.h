@@ -0,0 +1,132 @@
+#ifndef TERMINALSCROLLBACK_H
+#define TERMINALSCROLLBACK_H
+
+#include "TerminalCell.h"
+#include <QString>
+#include <QVector>
+#include <deque>
+
+// History of lines that scrolled off the top of the screen.
+//
+// Lines are stored unwrapped (one entry per logical line) in fixed-size pages. The row
+// layout at the current width is computed per page on first access, newest page first,
+// so a resize only records the new width and history is reflowed lazily as it is viewed
+// or searched. Each laid-out page also knows where it sits counted from the bottom, so
+// finding a row is a binary search over pages rather than a walk through history.
+class TerminalScrollback {
+public:
+    // One row of history laid out at the current width
+    struct RowView {
+        const TerminalCell* cells = nullptr;
+        int length = 0;
+        bool wrapped = false;
+        bool valid = false;
+    };
+
+    // Walks rows from the oldest to the most recent, splitting lines at the current
+    // width as it goes. Invalidated by any change to the scrollback.
+    class const_iterator {
+    public:
+        RowView operator*() const;
+        const_iterator& operator++();
+        bool operator==(const const_iterator& other) const
+        {
+            return m_page == other.m_page && m_line == other.m_line && m_start == other.m_start;
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class TerminalScrollback;
+        const_iterator(const TerminalScrollback* scrollback, int page)
+            : m_scrollback(scrollback), m_page(page), m_line(0), m_start(0)
+        {
+        }
+
+        const QVector<TerminalCell>& cells() const;
+
+        const TerminalScrollback* m_scrollback;
+        int m_page;
+        int m_line;
+        int m_start; // first cell of the current row within its line
+    };
+
+    explicit TerminalScrollback(int maxLines = 10000, int width = 80);
+
+    // Layout width; changing it is O(1)
+    void setWidth(int width);
+    int width() const { return m_width; }
+
+    // Capacity in logical lines
+    void setMaxLines(int lines);
+    int maxLines() const { return m_maxLines; }
+    int lineCount() const { return m_lineCount; }
+    bool isEmpty() const { return m_lineCount == 0; }
+
+    // Cells held in history and their approximate heap footprint; both are O(1)
+    qint64 cellCount() const { return m_cellCount; }
+    qint64 memoryUsage() const { return m_cellCount * qint64(sizeof(TerminalCell)); }
+
+    // Append a screen row that scrolled off; wrapped rows are joined with the next push
+    void pushRow(const TerminalLine& row);
+    // End the current logical line even if the last pushed row was wrapped
+    void closeLine() { m_lastOpen = false; }
+    void clear();
+
+    // Row access at the current width. Rows are counted from the bottom (0 is the most
+    // recent row) so that only the pages actually being looked at get laid out.
+    // rowFromBottom() is O(log pages) once those pages are laid out; rowCount() lays
+    // out everything the first time after a resize and is O(1) after that.
+    RowView rowFromBottom(int index) const;
+    int rowCount() const;
+
+    // Oldest row first; use these rather than rowFromBottom() to visit every row
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, static_cast<int>(m_pages.size())); }
+
+    // Search logical lines from row startRow (counted from the bottom) towards older
+    // history. Returns the row, counted from the bottom, where the match begins, or -1.
+    // Cluster ids are looked up in clusters, the table of the screen that owns this.
+    int findFromBottom(const QString& text, const ClusterTable& clusters, int startRow = 0,
+                       Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+
+private:
+    static constexpr int PageSize = 256;
+
+    struct Page {
+        QVector<QVector<TerminalCell>> lines;
+
+        // Layout at the current width, valid for the newest m_laidOut pages. rowStarts
+        // holds the first row of each line counted from the top of the page. bottom is
+        // the page's lowest row in a coordinate that grows upwards and does not move as
+        // rows are added below, so row n from the bottom of history is at m_bottom + n.
+        mutable int rowCount = 0;
+        mutable QVector<int> rowStarts;
+        mutable qint64 bottom = 0;
+
+        void layout(int width) const;
+    };
+
+    // Rows are split the way TerminalScreen wraps them, keeping wide characters whole
+    static int rowEnd(const QVector<TerminalCell>& cells, int start, int width);
+    static int rowsForLine(const QVector<TerminalCell>& cells, int width);
+    // Drops what a pushed row ends with that is not part of the line's text
+    static void finishRow(QVector<TerminalCell>& cells, const TerminalLine& row);
+    void enforceLineLimit();
+
+    // Lays out pages from the newest backwards until at least count are valid
+    void layoutNewest(int count) const;
+    // Adds rows below everything else to the newest page's layout, if it has one
+    void growNewestPage(int rows);
+    const Page& newestPage(int index) const { return m_pages[m_pages.size() - 1 - index]; }
+
+    std::deque<Page> m_pages;
+    int m_width;
+    int m_maxLines;
+    int m_lineCount;
+    qint64 m_cellCount;
+    bool m_lastOpen;
+    mutable int m_laidOut;
+    mutable qint64 m_bottom;
+};
+
+#endif // TERMINALSCROLLBACK_H
@@ -0,0 +1,103 @@
+#ifndef TERMINALSESSION_H
+#define TERMINALSESSION_H
+
+#include <QThread>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+
+class LatencyTracker;
+struct SessionMetrics;
+
+// Base class for the I/O thread behind a terminal tab. It owns what every backend
+// shares: the write queue, pending window-size changes and inbound flow control.
+// Subclasses implement run() against their transport (SSH channel, local PTY, ...).
+class TerminalSession : public QThread {
+    Q_OBJECT
+
+public:
+    // Default inbound flow-control watermarks (bytes emitted but not yet acknowledged)
+    static constexpr qint64 DefaultHighWatermark = 1024 * 1024;
+    static constexpr qint64 DefaultLowWatermark = 256 * 1024;
+
+    explicit TerminalSession(QObject* parent = nullptr);
+    ~TerminalSession();
+
+    // Thread control
+    void stop();
+
+    // Data transmission
+    void writeData(const QString& data);
+    void writeData(const QByteArray& data);
+
+    // Terminal size. Before start() this sets the initial PTY size; afterwards the new
+    // size is applied from the session thread.
+    void setTerminalSize(int rows, int cols);
+
+    // Inbound flow control. The consumer acknowledges every chunk delivered through
+    // dataReceived() once it has been applied; while more than the high watermark is
+    // unacknowledged the session stops reading from its transport, which throttles the
+    // producer. Reading resumes below the low watermark.
+    void acknowledgeData(qint64 bytes);
+    void setInboundWatermarks(qint64 high, qint64 low);
+    qint64 pendingInboundBytes() const;
+    bool isThrottled() const;
+    int backpressureCount() const;
+
+    // Optional keystroke latency probe; writes and reads are stamped from the session
+    // thread. The tracker must outlive the session.
+    void setLatencyTracker(LatencyTracker* tracker);
+
+    // Optional transport metrics (bytes, syscalls, queue depths); must outlive the session
+    void setMetrics(SessionMetrics* metrics);
+
+signals:
+    void dataReceived(const QByteArray& data);
+    void error(const QString& message);
+    void disconnected();
+    void backpressureChanged(bool throttled);
+
+protected:
+    // Called after a write, resize or stop request is queued so that a backend blocked
+    // in its transport can return early. Runs on the caller's thread.
+    virtual void interruptIo() {}
+
+    // Helpers for run() implementations
+    bool isStopRequested();
+    void requestStop();
+    void terminalSize(int& rows, int& cols);
+    bool takePendingResize(int& rows, int& cols);
+    bool takeWrite(QByteArray& data);
+    void clearWriteQueue();
+    void deliverData(const QByteArray& data);
+    void notifyRead();
+    void notifyWritten(qint64 bytes);
+    bool updateThrottleState();
+    void waitForDrain();
+
+private:
+    QMutex m_mutex;
+    QQueue<QByteArray> m_writeQueue;
+    QWaitCondition m_wakeCondition;
+    bool m_stopRequested;
+
+    // Requested PTY size, guarded by m_mutex
+    int m_rows;
+    int m_cols;
+    bool m_resizePending;
+
+    // Flow control state
+    QAtomicInteger<qint64> m_pendingBytes;
+    QAtomicInteger<qint64> m_highWatermark;
+    QAtomicInteger<qint64> m_lowWatermark;
+    QAtomicInt m_throttled;
+    QAtomicInt m_backpressureCount;
+
+    QAtomicPointer<LatencyTracker> m_latencyTracker;
+    QAtomicPointer<SessionMetrics> m_metrics;
+};
+
+#endif // TERMINALSESSION_H
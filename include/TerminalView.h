@@ -1,18 +1,30 @@
 #ifndef TERMINALVIEW_H
 #define TERMINALVIEW_H
 
+#include "ColorPalette.h"
+#include "GlyphCache.h"
 #include "TerminalEmulator.h"
 #include <QWidget>
 #include <QFont>
 #include <QTimer>
 
+class LatencyTracker;
+struct SessionMetrics;
+
 class TerminalView : public QWidget {
     Q_OBJECT
 
 public:
+    static constexpr int ResizeSettleDelay = 150;
+    // The window can shrink to this many cells; it opens at 80x24
+    static constexpr int MinimumColumns = 4;
+    static constexpr int MinimumRows = 2;
+
     explicit TerminalView(QWidget* parent = nullptr);
     ~TerminalView();
 
+    QSize sizeHint() const override;
+
     // Display operations
     void displayOutput(const QString& text);
     void displayOutput(const QByteArray& data);
@@ -25,13 +37,41 @@ public:
     // Buffer operations
     void clearDisplay();
 
+    // Scrollback viewing; the offset is the number of history rows shown above the screen
+    void scrollViewBy(int rows);
+    void scrollToBottom();
+    int scrollOffset() const { return m_scrollOffset; }
+
+    // Colours used to paint cells; switching recolours the scrollback as well
+    void setTheme(const ColorTheme& theme);
+    const ColorTheme& theme() const { return m_theme; }
+
+    // Programming-font ligatures ("->", "!=" drawn as one glyph); off by default
+    void setLigaturesEnabled(bool enabled);
+    bool ligaturesEnabled() const { return m_glyphs.ligaturesEnabled(); }
+
     // Emulator access
     TerminalEmulator& emulator() { return m_emulator; }
     const TerminalEmulator& emulator() const { return m_emulator; }
 
+    // Keystroke-to-photon latency probes; the tracker is owned by the caller
+    void setLatencyTracker(LatencyTracker* tracker);
+    LatencyTracker* latencyTracker() const { return m_latencyTracker; }
+    void setLatencyOverlayVisible(bool visible);
+    bool isLatencyOverlayVisible() const { return m_latencyOverlayVisible; }
+
+    // Parse/paint timings, frame counts and scrollback size; owned by the caller
+    void setMetrics(SessionMetrics* metrics);
+    SessionMetrics* metrics() const { return m_metrics; }
+    void setMetricsOverlayVisible(bool visible);
+    bool isMetricsOverlayVisible() const { return m_metricsOverlayVisible; }
+
 signals:
     void sendData(const QString& data);
     void dimensionsChanged(int rows, int columns);
+    // Emitted once the size has stopped changing for ResizeSettleDelay ms; this is
+    // the signal to forward to the remote PTY so a window drag causes a single redraw
+    void terminalSizeSettled(int rows, int columns);
 
 protected:
     void paintEvent(QPaintEvent* event) override;
@@ -40,11 +80,13 @@ protected:
     void mousePressEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
     void focusInEvent(QFocusEvent* event) override;
     void focusOutEvent(QFocusEvent* event) override;
 
 private slots:
     void blinkCursor();
+    void emitSettledSize();
 
 private:
     void setupTerminal();
@@ -52,18 +94,40 @@ private:
     void calculateMetrics();
     QString keyEventToString(QKeyEvent* event);
     QRect getCellRect(int row, int col) const;
+    void recordOutputApplied(qint64 parseNs);
+    QStringList latencyOverlayLines() const;
+    QStringList metricsOverlayLines() const;
+    void drawGlyphs(QPainter& painter, const QPoint& topLeft, const QString& text, int style);
+    void drawOverlay(QPainter& painter, const QStringList& lines);
 
     TerminalEmulator m_emulator;
     QFont m_font;
     int m_charWidth;
     int m_charHeight;
+    int m_charAscent;
     int m_rows;
     int m_columns;
+    int m_scrollOffset;
+
+    // Debounces window-change notifications while the widget is being resized
+    QTimer* m_resizeTimer;
 
     // Cursor blinking
     QTimer* m_cursorTimer;
     bool m_cursorVisible;
     bool m_hasFocus;
+
+    LatencyTracker* m_latencyTracker;
+    bool m_latencyOverlayVisible;
+    SessionMetrics* m_metrics;
+    bool m_metricsOverlayVisible;
+
+    // Set when output has requested a repaint that has not happened yet
+    bool m_framePending;
+
+    ColorTheme m_theme;
+    // Shaped text runs, reused across frames
+    GlyphCache m_glyphs;
 };
 
 #endif // TERMINALVIEW_H
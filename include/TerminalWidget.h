@@ -1,14 +1,13 @@
 #ifndef TERMINALWIDGET_H
 #define TERMINALWIDGET_H
 
-#include "ANSIParser.h"
-#include "TerminalBuffer.h"
 #include "FileTypeColorizer.h"
-#include <QWidget>
-#include <QTextEdit>
-#include <QFont>
+#include "TerminalView.h"
 
-class TerminalWidget : public QTextEdit {
+// Terminal widget with the original TerminalWidget API on top of the cell renderer:
+// output goes through TerminalEmulator and is painted by TerminalView, so memory is
+// bounded by the screen and scrollback. Adds optional colouring of plain ls output.
+class TerminalWidget : public TerminalView {
     Q_OBJECT
 
 public:
@@ -16,15 +15,12 @@ public:
     ~TerminalWidget();
 
     // Display operations
+    using TerminalView::displayOutput;
     void displayOutput(const QString& text);
+    // Scrollback followed by the screen as plain text, soft-wrapped rows joined
     QString getDisplayedText() const;
 
-    // Terminal dimensions
-    void setDimensions(int rows, int columns);
-    int rows() const;
-    int columns() const;
-
-    // Buffer operations
+    // Buffer operations; clearing also drops the scrollback
     void clearDisplay();
     void setMaxScrollback(int lines);
 
@@ -32,43 +28,9 @@ public:
     void setFileColoringEnabled(bool enabled);
     bool isFileColoringEnabled() const;
 
-signals:
-    void sendData(const QString& data);
-    void dimensionsChanged(int rows, int columns);
-
-protected:
-    // Event handlers
-    void keyPressEvent(QKeyEvent* event) override;
-    void resizeEvent(QResizeEvent* event) override;
-    void mousePressEvent(QMouseEvent* event) override;
-    void mouseReleaseEvent(QMouseEvent* event) override;
-    void mouseMoveEvent(QMouseEvent* event) override;
-
 private:
-    struct ColorToken {
-        QString text;
-        QColor fgColor;
-        QColor bgColor;
-        bool bold = false;
-    };
-
-    void setupTerminal();
-    void setupFont();
-    void processANSIOutput(const QString& text);
-    void applyTextFormat(const ANSIParser::TextFormat& format);
-    void handleKeyInput(QKeyEvent* event);
-    QString keyEventToString(QKeyEvent* event);
-    void updateDisplayFromBuffer();
-    QVector<ColorToken> parseAnsiWithColors(const QString& text);
-    QColor getAnsiColor(int colorCode, bool bright);
-    QColor get256Color(int index);
+    static bool looksLikeLsOutput(const QString& text);
 
-    ANSIParser m_ansiParser;
-    TerminalBuffer m_buffer;
-    QFont m_terminalFont;
-    int m_rows;
-    int m_columns;
-    ANSIParser::TextFormat m_currentFormat;
     FileTypeColorizer m_fileColorizer;
     bool m_enableFileColoring;
 };
@@ -0,0 +1,112 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+struct TraceBuffer;
+
+// Pipeline span tracing exported in the Chrome trace event format, which both
+// chrome://tracing and ui.perfetto.dev load.
+//
+// Each thread records into its own fixed-size ring, so recording takes no lock and
+// never allocates after the first span on a thread. When a thread ends its ring is
+// kept for export and handed to the next thread that starts tracing. Recording is off
+// by default, and a TRACE_SPAN() then costs one relaxed atomic load; builds configured
+// with ENABLE_TRACING=OFF compile it away entirely. Spans publish the phase their
+// thread is in for other threads to read while recording, and TRACE_PHASE() spans
+// always do.
+class Tracer {
+public:
+    enum Phase {
+        Idle,
+        Read,
+        Decode,
+        Parse,
+        ScreenUpdate,
+        Paint,
+        Write,
+        Connect,
+        PhaseCount
+    };
+
+    // Events kept per thread; older events are overwritten
+    static constexpr int EventsPerThread = 65536;
+
+    static bool isEnabled() { return s_enabled.loadRelaxed() != 0; }
+    static void setEnabled(bool enabled);
+
+    // Phase a thread is currently in, or Idle if it never entered a span
+    static Phase currentPhase(Qt::HANDLE threadId);
+    static const char* phaseName(Phase phase);
+
+    // Everything recorded so far as a Chrome trace JSON document
+    static QByteArray exportChromeTrace();
+    static bool writeChromeTrace(const QString& path, QString* errorMessage = nullptr);
+    // Drops recorded events; meant to be called while recording is off
+    static void clear();
+
+    static quint64 now();
+
+    // RAII span; use through TRACE_SPAN()
+    class Span {
+    public:
+        explicit Span(Phase phase) : Span(phase, false) {}
+        ~Span()
+        {
+            if (m_buffer) {
+                end();
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    protected:
+        // With publish set the phase is published even while recording is off
+        Span(Phase phase, bool publish)
+            : m_buffer(nullptr), m_phase(phase), m_previous(Idle), m_startNs(0)
+        {
+            if (publish || isEnabled()) {
+                begin();
+            }
+        }
+
+    private:
+        void begin();
+        void end();
+
+        TraceBuffer* m_buffer;
+        Phase m_phase;
+        Phase m_previous;
+        quint64 m_startNs;
+    };
+
+    // Span that always publishes its phase; use through TRACE_PHASE()
+    class PhaseSpan : public Span {
+    public:
+        explicit PhaseSpan(Phase phase) : Span(phase, true) {}
+    };
+
+private:
+    static TraceBuffer* threadBuffer();
+
+    static QAtomicInt s_enabled;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+// Like TRACE_SPAN(), but kept in builds without tracing: for spans whose phase other
+// threads act on, such as the stall watchdog not signalling a thread in Connect
+#define TRACE_PHASE(phase) Tracer::PhaseSpan TRACE_CONCAT(traceSpan, __LINE__)(Tracer::phase)
+
+#ifdef SSH_CLIENT_TRACING
+#define TRACE_SPAN(phase) Tracer::Span TRACE_CONCAT(traceSpan, __LINE__)(Tracer::phase)
+#else
+#define TRACE_SPAN(phase) static_cast<void>(0)
+#endif
+
+#endif // TRACER_H
@@ -0,0 +1,32 @@
+#ifndef UTF8DECODER_H
+#define UTF8DECODER_H
+
+#include <QByteArray>
+#include <QString>
+
+// Decodes a UTF-8 byte stream read in arbitrary chunks. A character cut off at the
+// end of a chunk is held back and completed by the next one; each malformed sequence
+// becomes one U+FFFD.
+namespace Unicode {
+
+class Utf8Decoder {
+public:
+    // Replaces out with the text of data, reusing its capacity
+    void decode(const char* data, int size, QString& out);
+    void decode(const QByteArray& bytes, QString& out)
+    {
+        decode(bytes.constData(), bytes.size(), out);
+    }
+
+    bool hasPending() const { return m_pendingSize > 0; }
+    void reset() { m_pendingSize = 0; }
+
+private:
+    // Lead byte and continuation bytes of the held-back character
+    char m_pending[4];
+    int m_pendingSize = 0;
+};
+
+} // namespace Unicode
+
+#endif // UTF8DECODER_H
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Compare Google Benchmark JSON output against a stored baseline.
+
+Usage:
+    compare_bench.py <results.json> <baseline.json> [--tolerance 0.10] [--update]
+
+A benchmark regresses when its time grows by more than the tolerance relative to
+the baseline. When the run used repetitions, the median aggregate is compared.
+A missing baseline is not an error: the comparison is skipped, and --update
+records the current results as the new baseline. Baselines are machine-specific,
+so record them on the machine that runs the comparison.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import sys
+
+
+def load_times(path):
+    with open(path) as handle:
+        data = json.load(handle)
+
+    times = {}
+    medians = {}
+    unit = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        name = bench.get("run_name", bench["name"])
+        value = bench.get("real_time")
+        if value is None:
+            continue
+        unit[name] = bench.get("time_unit", "ns")
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[name] = value
+        else:
+            times.setdefault(name, value)
+
+    # Prefer medians over single iterations when repetitions were requested
+    times.update(medians)
+    return times, unit
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("results", help="JSON written with --benchmark_out")
+    parser.add_argument("baseline", help="Stored baseline JSON")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="Allowed relative slowdown (default 0.10 = 10%%)")
+    parser.add_argument("--update", action="store_true",
+                        help="Replace the baseline with the current results")
+    args = parser.parse_args()
+
+    if args.update:
+        os.makedirs(os.path.dirname(os.path.abspath(args.baseline)), exist_ok=True)
+        shutil.copyfile(args.results, args.baseline)
+        print("Baseline updated: %s" % args.baseline)
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print("No baseline at %s; skipping comparison (use --update to record one)"
+              % args.baseline)
+        return 0
+
+    current, units = load_times(args.results)
+    baseline, _ = load_times(args.baseline)
+
+    regressions = []
+    print("%-48s %14s %14s %9s" % ("Benchmark", "Baseline", "Current", "Change"))
+    for name in sorted(current):
+        if name not in baseline:
+            print("%-48s %14s %14.1f %9s" % (name, "-", current[name], "new"))
+            continue
+
+        change = (current[name] - baseline[name]) / baseline[name] if baseline[name] else 0.0
+        marker = ""
+        if change > args.tolerance:
+            marker = "  REGRESSION"
+            regressions.append(name)
+        print("%-48s %12.1f%-2s %12.1f%-2s %+8.1f%%%s"
+              % (name, baseline[name], units[name], current[name], units[name],
+                 change * 100.0, marker))
+
+    for name in sorted(set(baseline) - set(current)):
+        print("%-48s missing from current results" % name)
+
+    if regressions:
+        print("\n%d benchmark(s) slower than baseline by more than %.0f%%: %s"
+              % (len(regressions), args.tolerance * 100.0, ", ".join(regressions)))
+        return 1
+
+    print("\nNo regressions beyond %.0f%%" % (args.tolerance * 100.0))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
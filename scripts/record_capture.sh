@@ -0,0 +1,57 @@
+#!/bin/bash
+# Record the raw output of a terminal program for the replay benchmark corpus
+#
+# Usage: scripts/record_capture.sh <name> <rows> <cols> <command...>
+#
+# The command runs on a pseudo-terminal of the given size under script(1) with
+# TERM=xterm-256color; everything it writes (escape sequences included) is stored
+# unmodified in tests/performance/replay/<name>.cap.
+
+set -e
+
+if [ $# -lt 4 ]; then
+    echo "Usage: $0 <name> <rows> <cols> <command...>" >&2
+    exit 2
+fi
+
+NAME="$1"
+ROWS="$2"
+COLS="$3"
+shift 3
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+CORPUS_DIR="${CORPUS_DIR:-$SCRIPT_DIR/../tests/performance/replay}"
+OUTPUT="$CORPUS_DIR/$NAME.cap"
+
+if ! command -v script >/dev/null 2>&1; then
+    echo "script(1) is required to record captures" >&2
+    exit 1
+fi
+
+mkdir -p "$CORPUS_DIR"
+
+# Quote the command so it survives the extra shell level inside script(1)
+COMMAND=$(printf '%q ' "$@")
+
+# Programs like compilers are expected to fail; keep the capture regardless
+STATUS=0
+case "$(uname -s)" in
+    Linux)
+        TERM=xterm-256color script -q -e --log-out "$OUTPUT" \
+            -c "stty rows $ROWS cols $COLS; $COMMAND" </dev/null >/dev/null || STATUS=$?
+        ;;
+    Darwin | *BSD)
+        TERM=xterm-256color script -q "$OUTPUT" \
+            /bin/sh -c "stty rows $ROWS cols $COLS; $COMMAND" </dev/null >/dev/null || STATUS=$?
+        ;;
+    *)
+        echo "Unsupported platform: $(uname -s)" >&2
+        exit 1
+        ;;
+esac
+
+# Drop the banner lines script(1) adds around the session
+sed -i.bak -e '1{/^Script started/d;}' -e '${/^Script done/d;}' "$OUTPUT"
+rm -f "$OUTPUT.bak"
+
+echo "Recorded $(wc -c <"$OUTPUT") bytes to $OUTPUT (exit status $STATUS)"
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Print deterministic terminal workloads that are awkward to record from real tools.
+
+Used with record_capture.sh to build the replay corpus, e.g.
+
+    scripts/record_capture.sh progress_bars 40 120 scripts/synthetic_output.py progress
+"""
+
+import math
+import sys
+
+
+def progress(out):
+    # Package-manager style: one bar per item redrawn in place with \r
+    width = 50
+    for item in range(60):
+        name = "package-%03d" % item
+        for percent in range(0, 101, 2):
+            filled = width * percent // 100
+            bar = "\x1b[32m" + "#" * filled + "\x1b[90m" + "-" * (width - filled) + "\x1b[0m"
+            out.write("\r%-16s [%s] %3d%% %6.1f MB/s\x1b[K" % (name, bar, percent,
+                                                              1.5 + (item * percent) % 37))
+        out.write("\r\x1b[1;32m    Finished\x1b[0m %s\x1b[K\n" % name)
+
+
+def color256(out):
+    # Half-block art cycling through the 6x6x6 cube and grayscale ramp
+    rows, cols = 38, 120
+    for frame in range(4):
+        out.write("\x1b[H")
+        for row in range(rows):
+            for col in range(cols):
+                top = 16 + (row * 2 + col + frame * 7) % 216
+                bottom = 232 + (row + col // 4 + frame) % 24
+                out.write("\x1b[38;5;%dm\x1b[48;5;%dm▀" % (top, bottom))
+            out.write("\x1b[0m\r\n")
+
+
+def truecolor(out):
+    # Plasma-style RGB gradients, as produced by image-to-terminal converters
+    rows, cols = 38, 120
+    for frame in range(3):
+        out.write("\x1b[H")
+        for row in range(rows):
+            for col in range(cols):
+                fg = _plasma(col, row * 2, frame)
+                bg = _plasma(col, row * 2 + 1, frame)
+                out.write("\x1b[38;2;%d;%d;%dm\x1b[48;2;%d;%d;%dm▀" % (fg + bg))
+            out.write("\x1b[0m\r\n")
+
+
+def _plasma(x, y, t):
+    v = math.sin(x / 9.0 + t) + math.sin(y / 7.0 - t) + math.sin((x + y) / 13.0)
+    r = int(127 + 127 * math.sin(v * math.pi))
+    g = int(127 + 127 * math.sin(v * math.pi + 2.094))
+    b = int(127 + 127 * math.sin(v * math.pi + 4.188))
+    return (r, g, b)
+
+
+def main():
+    kinds = {"progress": progress, "color256": color256, "truecolor": truecolor}
+    if len(sys.argv) != 2 or sys.argv[1] not in kinds:
+        sys.stderr.write("usage: %s {%s}\n" % (sys.argv[0], "|".join(sorted(kinds))))
+        return 2
+
+    kinds[sys.argv[1]](sys.stdout)
+    sys.stdout.flush()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
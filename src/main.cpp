@@ -1,6 +1,9 @@
 #include "MainWindow.h"
 #include "Logger.h"
+#include "StallWatchdog.h"
+#include "Tracer.h"
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char* argv[])
 {
@@ -11,13 +14,65 @@ int main(int argc, char* argv[])
     QCoreApplication::setApplicationName("SSH Client");
     QCoreApplication::setApplicationVersion("1.0.0");
 
-    // Initialize logging
+    // Initialize logging; SSH_CLIENT_BINARY_LOG=1 writes the compact binary format
+    // (read it with blog-decode)
+    Logger::instance().setBinaryMode(qEnvironmentVariableIntValue("SSH_CLIENT_BINARY_LOG") != 0);
     Logger::instance().initialize();
     qInfo(ui) << "Application started - version" << QCoreApplication::applicationVersion();
 
+    // Local sessions allow profiling the terminal pipeline without an SSH server
+    QCommandLineParser parser;
+    parser.setApplicationDescription("SSH Client");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption localOption("local", "Open a local terminal running the user shell.");
+    QCommandLineOption execOption("exec", "Open a local terminal running <command> via /bin/sh.",
+                                  "command");
+    parser.addOption(localOption);
+    parser.addOption(execOption);
+    parser.process(app);
+
+    // SSH_CLIENT_TRACE=<file> records pipeline spans from startup and writes a Chrome
+    // trace on exit
+    const QString tracePath = qEnvironmentVariable("SSH_CLIENT_TRACE");
+    if (!tracePath.isEmpty()) {
+        Tracer::setEnabled(true);
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [tracePath]() {
+            QString errorMessage;
+            if (Tracer::writeChromeTrace(tracePath, &errorMessage)) {
+                qInfo(metrics) << "Trace written to" << tracePath;
+            } else {
+                qWarning(metrics) << "Cannot write trace to" << tracePath << errorMessage;
+            }
+        });
+    }
+
     // Create and show main window
     MainWindow window;
     window.show();
 
-    return app.exec();
+    if (parser.isSet(execOption)) {
+        window.openLocalTerminal("/bin/sh", {"-c", parser.value(execOption)});
+    } else if (parser.isSet(localOption)) {
+        window.openLocalTerminal();
+    }
+
+    // GUI stall reports go to the log directory; SSH_CLIENT_STALL_MS sets the threshold
+    // and 0 turns the watchdog off
+    StallWatchdog watchdog;
+    bool thresholdSet = false;
+    const int stallThresholdMs = qEnvironmentVariableIntValue("SSH_CLIENT_STALL_MS", &thresholdSet);
+    if (!thresholdSet || stallThresholdMs > 0) {
+        if (thresholdSet) {
+            watchdog.setThresholdMs(stallThresholdMs);
+        }
+        watchdog.start(QThread::LowPriority);
+    }
+
+    int result = app.exec();
+    watchdog.stop();
+
+    // Write out everything still queued for the log
+    Logger::instance().shutdown();
+    return result;
 }
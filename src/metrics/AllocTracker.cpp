@@ -0,0 +1,237 @@
+#include "AllocTracker.h"
+#include <QAtomicInteger>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Constant-initialised so allocations made before main() are counted safely
+struct SubsystemCounters {
+    QAtomicInteger<quint64> allocations;
+    QAtomicInteger<quint64> bytes;
+    QAtomicInteger<quint64> frees;
+};
+
+SubsystemCounters s_counters[AllocTracker::SubsystemCount];
+
+thread_local int s_currentSubsystem = AllocTracker::Untagged;
+
+} // namespace
+
+AllocTracker::Counts AllocTracker::counts(Subsystem subsystem)
+{
+    Counts result;
+    if (subsystem < 0 || subsystem >= SubsystemCount) {
+        return result;
+    }
+    const SubsystemCounters& counters = s_counters[subsystem];
+    result.allocations = counters.allocations.loadRelaxed();
+    result.bytes = counters.bytes.loadRelaxed();
+    result.frees = counters.frees.loadRelaxed();
+    return result;
+}
+
+AllocTracker::Counts AllocTracker::total()
+{
+    Counts result;
+    for (int i = 0; i < SubsystemCount; ++i) {
+        Counts subsystem = counts(static_cast<Subsystem>(i));
+        result.allocations += subsystem.allocations;
+        result.bytes += subsystem.bytes;
+        result.frees += subsystem.frees;
+    }
+    return result;
+}
+
+const char* AllocTracker::subsystemName(Subsystem subsystem)
+{
+    switch (subsystem) {
+    case Untagged:
+        return "untagged";
+    case Parser:
+        return "parser";
+    case Screen:
+        return "screen";
+    case Scrollback:
+        return "scrollback";
+    case Io:
+        return "io";
+    case Ui:
+        return "ui";
+    case SubsystemCount:
+        break;
+    }
+    return "unknown";
+}
+
+QJsonObject AllocTracker::toJson()
+{
+    QJsonObject json;
+    for (int i = 0; i < SubsystemCount; ++i) {
+        Subsystem subsystem = static_cast<Subsystem>(i);
+        Counts subsystemCounts = counts(subsystem);
+        QJsonObject entry;
+        entry["allocations"] = static_cast<qint64>(subsystemCounts.allocations);
+        entry["bytes"] = static_cast<qint64>(subsystemCounts.bytes);
+        entry["frees"] = static_cast<qint64>(subsystemCounts.frees);
+        json[subsystemName(subsystem)] = entry;
+    }
+    return json;
+}
+
+AllocTracker::Subsystem AllocTracker::currentSubsystem()
+{
+    return static_cast<Subsystem>(s_currentSubsystem);
+}
+
+void AllocTracker::recordAllocation(std::size_t bytes)
+{
+    SubsystemCounters& counters = s_counters[s_currentSubsystem];
+    counters.allocations.fetchAndAddRelaxed(1);
+    counters.bytes.fetchAndAddRelaxed(bytes);
+}
+
+void AllocTracker::recordFree()
+{
+    s_counters[s_currentSubsystem].frees.fetchAndAddRelaxed(1);
+}
+
+AllocTracker::Scope::Scope(Subsystem subsystem)
+    : m_previous(static_cast<Subsystem>(s_currentSubsystem))
+{
+    s_currentSubsystem = subsystem;
+}
+
+AllocTracker::Scope::~Scope()
+{
+    s_currentSubsystem = m_previous;
+}
+
+#ifdef SSH_CLIENT_ALLOC_TRACKING
+
+// The replacements live in this file so that any binary using ALLOC_SCOPE() links them
+// in from terminal-core.
+
+#ifdef __GLIBC__
+// glibc exports its allocator under these names as well, which lets malloc() be
+// replaced without dlsym (which itself allocates)
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void __libc_free(void* ptr);
+}
+
+#define ALLOC_TRACKER_MALLOC __libc_malloc
+#define ALLOC_TRACKER_FREE __libc_free
+
+extern "C" void* malloc(std::size_t size)
+{
+    AllocTracker::recordAllocation(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(std::size_t count, std::size_t size)
+{
+    AllocTracker::recordAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, std::size_t size)
+{
+    // A resize counts as a new allocation (and a free when it replaces a block)
+    if (ptr) {
+        AllocTracker::recordFree();
+    }
+    AllocTracker::recordAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void* ptr)
+{
+    if (ptr) {
+        AllocTracker::recordFree();
+    }
+    __libc_free(ptr);
+}
+#else
+#define ALLOC_TRACKER_MALLOC std::malloc
+#define ALLOC_TRACKER_FREE std::free
+#endif
+
+namespace {
+
+// Bypasses the counting malloc() above so operator new is counted exactly once
+void* trackedNew(std::size_t size)
+{
+    AllocTracker::recordAllocation(size);
+    return ALLOC_TRACKER_MALLOC(size ? size : 1);
+}
+
+void trackedDelete(void* ptr) noexcept
+{
+    if (ptr) {
+        AllocTracker::recordFree();
+    }
+    ALLOC_TRACKER_FREE(ptr);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    if (void* ptr = trackedNew(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* ptr = trackedNew(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return trackedNew(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return trackedNew(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    trackedDelete(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    trackedDelete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    trackedDelete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    trackedDelete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    trackedDelete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    trackedDelete(ptr);
+}
+
+#endif // SSH_CLIENT_ALLOC_TRACKING
@@ -0,0 +1,117 @@
+#include "Histogram.h"
+#include <QtAlgorithms>
+#include <limits>
+
+namespace {
+constexpr quint64 NoMinimum = std::numeric_limits<quint64>::max();
+} // namespace
+
+Histogram::Histogram() : m_count(0), m_sum(0), m_min(NoMinimum), m_max(0)
+{
+    for (auto& bucket : m_buckets) {
+        bucket.storeRelaxed(0);
+    }
+}
+
+int Histogram::bucketIndex(quint64 value)
+{
+    if (value < static_cast<quint64>(SubBucketCount)) {
+        return static_cast<int>(value);
+    }
+
+    // Magnitude m >= 1 holds values in [32 << (m - 1), 32 << m)
+    int msb = 63 - qCountLeadingZeroBits(value);
+    int magnitude = msb - SubBucketBits + 1;
+    if (magnitude >= MagnitudeCount) {
+        return BucketCount - 1;
+    }
+
+    int subBucket = static_cast<int>(value >> (magnitude - 1)) - SubBucketCount;
+    return magnitude * SubBucketCount + subBucket;
+}
+
+quint64 Histogram::bucketUpperBound(int index)
+{
+    int magnitude = index / SubBucketCount;
+    quint64 subBucket = static_cast<quint64>(index % SubBucketCount);
+    if (magnitude == 0) {
+        return subBucket;
+    }
+    return ((subBucket + SubBucketCount + 1) << (magnitude - 1)) - 1;
+}
+
+void Histogram::record(quint64 value)
+{
+    m_buckets[bucketIndex(value)].fetchAndAddRelaxed(1);
+    m_count.fetchAndAddRelaxed(1);
+    m_sum.fetchAndAddRelaxed(value);
+
+    quint64 current = m_min.loadRelaxed();
+    while (value < current && !m_min.testAndSetRelaxed(current, value, current)) {
+    }
+    current = m_max.loadRelaxed();
+    while (value > current && !m_max.testAndSetRelaxed(current, value, current)) {
+    }
+}
+
+void Histogram::reset()
+{
+    for (auto& bucket : m_buckets) {
+        bucket.storeRelaxed(0);
+    }
+    m_count.storeRelaxed(0);
+    m_sum.storeRelaxed(0);
+    m_min.storeRelaxed(NoMinimum);
+    m_max.storeRelaxed(0);
+}
+
+quint64 Histogram::min() const
+{
+    quint64 value = m_min.loadRelaxed();
+    return value == NoMinimum ? 0 : value;
+}
+
+double Histogram::mean() const
+{
+    quint64 samples = count();
+    return samples ? static_cast<double>(m_sum.loadRelaxed()) / samples : 0.0;
+}
+
+quint64 Histogram::percentile(double percent) const
+{
+    quint64 total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    quint64 target = static_cast<quint64>(qBound(0.0, percent, 100.0) / 100.0 * total + 0.5);
+    target = qMax<quint64>(target, 1);
+
+    quint64 seen = 0;
+    for (int index = 0; index < BucketCount; ++index) {
+        seen += m_buckets[index].loadRelaxed();
+        if (seen >= target) {
+            // Never report beyond the largest value actually recorded; the last bucket
+            // also holds every value too large for the others
+            if (index == BucketCount - 1) {
+                return max();
+            }
+            return qMin(bucketUpperBound(index), max());
+        }
+    }
+    return max();
+}
+
+QJsonObject Histogram::toJson(double divisor) const
+{
+    QJsonObject json;
+    json["count"] = static_cast<qint64>(count());
+    json["min"] = min() / divisor;
+    json["max"] = max() / divisor;
+    json["mean"] = mean() / divisor;
+    json["p50"] = percentile(50.0) / divisor;
+    json["p90"] = percentile(90.0) / divisor;
+    json["p99"] = percentile(99.0) / divisor;
+    json["p999"] = percentile(99.9) / divisor;
+    return json;
+}
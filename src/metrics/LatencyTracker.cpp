@@ -0,0 +1,136 @@
+#include "LatencyTracker.h"
+#include <chrono>
+
+LatencyTracker::LatencyTracker()
+    : m_stage(Idle), m_keyPressNs(0), m_writeNs(0), m_echoNs(0), m_appliedNs(0), m_completed(0),
+      m_abandoned(0)
+{
+}
+
+quint64 LatencyTracker::now()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+}
+
+const char* LatencyTracker::segmentName(Segment segment)
+{
+    switch (segment) {
+    case KeyToWrite:
+        return "key_to_write";
+    case WriteToEcho:
+        return "write_to_echo";
+    case EchoToApply:
+        return "echo_to_apply";
+    case ApplyToPaint:
+        return "apply_to_paint";
+    case KeyToPaint:
+        return "key_to_paint";
+    case SegmentCount:
+        break;
+    }
+    return "unknown";
+}
+
+bool LatencyTracker::advance(Stage from, Stage to)
+{
+    // Timestamps are stored before the stage moves, so whoever observes the new
+    // stage (acquire) also sees the timestamp
+    return m_stage.testAndSetOrdered(from, to);
+}
+
+void LatencyTracker::markKeyPress()
+{
+    quint64 timestamp = now();
+    int stage = m_stage.loadAcquire();
+
+    if (stage != Idle) {
+        if (timestamp - m_keyPressNs.loadRelaxed() < ProbeTimeoutNs) {
+            return;
+        }
+        if (!m_stage.testAndSetOrdered(stage, Idle)) {
+            return;
+        }
+        m_abandoned.fetchAndAddRelaxed(1);
+    }
+
+    m_keyPressNs.storeRelaxed(timestamp);
+    advance(Idle, KeyPressed);
+}
+
+void LatencyTracker::markWrite()
+{
+    if (m_stage.loadRelaxed() != KeyPressed) {
+        return;
+    }
+    m_writeNs.storeRelaxed(now());
+    advance(KeyPressed, Written);
+}
+
+void LatencyTracker::markEcho()
+{
+    if (m_stage.loadRelaxed() != Written) {
+        return;
+    }
+    m_echoNs.storeRelaxed(now());
+    advance(Written, Echoed);
+}
+
+void LatencyTracker::markApplied()
+{
+    if (m_stage.loadRelaxed() != Echoed) {
+        return;
+    }
+    m_appliedNs.storeRelaxed(now());
+    advance(Echoed, Applied);
+}
+
+void LatencyTracker::markPainted()
+{
+    if (m_stage.loadAcquire() != Applied) {
+        return;
+    }
+
+    quint64 painted = now();
+    quint64 keyPress = m_keyPressNs.loadRelaxed();
+    quint64 write = m_writeNs.loadRelaxed();
+    quint64 echo = m_echoNs.loadRelaxed();
+    quint64 applied = m_appliedNs.loadRelaxed();
+
+    if (!advance(Applied, Idle)) {
+        return;
+    }
+
+    m_histograms[KeyToWrite].record(write - keyPress);
+    m_histograms[WriteToEcho].record(echo - write);
+    m_histograms[EchoToApply].record(applied - echo);
+    m_histograms[ApplyToPaint].record(painted - applied);
+    m_histograms[KeyToPaint].record(painted - keyPress);
+    m_completed.fetchAndAddRelaxed(1);
+}
+
+void LatencyTracker::reset()
+{
+    m_stage.storeRelease(Idle);
+    for (Histogram& histogram : m_histograms) {
+        histogram.reset();
+    }
+    m_completed.storeRelaxed(0);
+    m_abandoned.storeRelaxed(0);
+}
+
+QJsonObject LatencyTracker::toJson() const
+{
+    QJsonObject json;
+    json["completed_probes"] = static_cast<qint64>(completedProbes());
+    json["abandoned_probes"] = static_cast<qint64>(abandonedProbes());
+
+    QJsonObject segments;
+    for (int segment = 0; segment < SegmentCount; ++segment) {
+        segments[segmentName(static_cast<Segment>(segment))] =
+            m_histograms[segment].toJson(1e6);
+    }
+    json["segments_ms"] = segments;
+    return json;
+}
@@ -0,0 +1,68 @@
+#include "Metrics.h"
+#include "AllocTracker.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QMutexLocker>
+
+QJsonObject SessionMetrics::toJson() const
+{
+    QJsonObject json;
+    json["name"] = name;
+    json["bytes_in"] = static_cast<qint64>(bytesIn.value());
+    json["bytes_out"] = static_cast<qint64>(bytesOut.value());
+    json["read_calls"] = static_cast<qint64>(readCalls.value());
+    json["write_calls"] = static_cast<qint64>(writeCalls.value());
+    json["write_queue_depth"] = writeQueueDepth.value();
+    json["inbound_pending_bytes"] = inboundPendingBytes.value();
+    json["parse_time_ms"] = parseTimeNs.toJson(1e6);
+    json["paint_time_ms"] = paintTimeNs.toJson(1e6);
+    json["frames_rendered"] = static_cast<qint64>(framesRendered.value());
+    json["frames_skipped"] = static_cast<qint64>(framesSkipped.value());
+    json["scrollback_bytes"] = scrollbackBytes.value();
+    return json;
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+void MetricsRegistry::add(SessionMetrics* metrics)
+{
+    QMutexLocker locker(&m_mutex);
+    if (metrics && !m_sessions.contains(metrics)) {
+        m_sessions.append(metrics);
+    }
+}
+
+void MetricsRegistry::remove(SessionMetrics* metrics)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sessions.removeAll(metrics);
+}
+
+int MetricsRegistry::sessionCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_sessions.size();
+}
+
+QJsonObject MetricsRegistry::toJson() const
+{
+    QJsonArray sessions;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const SessionMetrics* metrics : m_sessions) {
+            sessions.append(metrics->toJson());
+        }
+    }
+
+    QJsonObject json;
+    json["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+    json["sessions"] = sessions;
+    if (AllocTracker::isCompiledIn()) {
+        json["allocations"] = AllocTracker::toJson();
+    }
+    return json;
+}
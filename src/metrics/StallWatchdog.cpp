@@ -0,0 +1,243 @@
+#include "StallWatchdog.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaObject>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#define STALL_WATCHDOG_BACKTRACE
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <cstdlib>
+#endif
+
+namespace {
+
+// How often an acknowledged ping is followed by the next one
+constexpr unsigned long PingIntervalMs = 100;
+// Polling granularity while a ping is outstanding
+constexpr unsigned long PollIntervalMs = 10;
+
+#ifdef STALL_WATCHDOG_BACKTRACE
+constexpr int BacktraceSignal = SIGUSR2;
+constexpr int MaxFrames = 64;
+// How long the watchdog waits for the GUI thread to run the signal handler
+constexpr int BacktraceTimeoutMs = 200;
+
+pthread_t s_guiThread;
+void* s_frames[MaxFrames];
+QAtomicInt s_frameCount(-1);
+
+void backtraceSignalHandler(int)
+{
+    // backtrace() was called once at startup, so it does not need to load libgcc here
+    s_frameCount.storeRelease(backtrace(s_frames, MaxFrames));
+}
+#endif
+
+QByteArray jsonString(const QString& text)
+{
+    QByteArray out = "\"";
+    for (QChar ch : text) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += static_cast<char>(ch.unicode());
+        } else if (ch.unicode() < 0x20) {
+            out += "\\u00" + QByteArray::number(ch.unicode(), 16).rightJustified(2, '0');
+        } else {
+            out += QString(ch).toUtf8();
+        }
+    }
+    out += '"';
+    return out;
+}
+
+} // namespace
+
+StallWatchdog::StallWatchdog(QObject* parent)
+    : QThread(parent), m_guiThreadId(QThread::currentThreadId()),
+      m_thresholdMs(DefaultThresholdMs), m_reportsWritten(0), m_acknowledged(0),
+      m_stallCount(0)
+{
+    setObjectName("StallWatchdog");
+    m_reportDirectory = QFileInfo(Logger::instance().logFilePath()).absolutePath();
+
+#ifdef STALL_WATCHDOG_BACKTRACE
+    s_guiThread = pthread_self();
+    void* warmup[1];
+    backtrace(warmup, 1);
+
+    struct sigaction action = {};
+    action.sa_handler = backtraceSignalHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(BacktraceSignal, &action, nullptr);
+#endif
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+}
+
+void StallWatchdog::setThresholdMs(int thresholdMs)
+{
+    m_thresholdMs = qMax(50, thresholdMs);
+}
+
+void StallWatchdog::setReportDirectory(const QString& directory)
+{
+    m_reportDirectory = directory;
+}
+
+void StallWatchdog::stop()
+{
+    if (isRunning()) {
+        requestInterruption();
+        wait();
+    }
+}
+
+void StallWatchdog::ping(quint64 sequence)
+{
+    QMetaObject::invokeMethod(
+        &m_guiContext, [this, sequence]() { m_acknowledged.storeRelease(sequence); },
+        Qt::QueuedConnection);
+}
+
+void StallWatchdog::run()
+{
+    QElapsedTimer clock;
+    clock.start();
+    quint64 sequence = 0;
+
+    while (!isInterruptionRequested()) {
+        ping(++sequence);
+        const qint64 sentAt = clock.elapsed();
+        qint64 lastPoll = sentAt;
+        bool sampled = false;
+        bool suspended = false;
+        Stall stall;
+
+        while (m_acknowledged.loadAcquire() < sequence && !isInterruptionRequested()) {
+            msleep(PollIntervalMs);
+            const qint64 now = clock.elapsed();
+
+            // The watchdog itself missed its wake-ups (system suspend, debugger): the
+            // GUI thread was not stalled any more than we were
+            if (now - lastPoll > m_thresholdMs) {
+                suspended = true;
+            }
+            lastPoll = now;
+
+            if (!sampled && now - sentAt >= m_thresholdMs) {
+                sample(stall);
+                sampled = true;
+            }
+        }
+
+        if (isInterruptionRequested()) {
+            break;
+        }
+
+        if (sampled && !suspended) {
+            stall.durationMs = clock.elapsed() - sentAt;
+            m_stallCount.fetchAndAddRelaxed(1);
+
+            QString reportPath;
+            if (m_reportsWritten < MaxReports) {
+                reportPath = writeReport(stall);
+                ++m_reportsWritten;
+            }
+            qWarning(ui) << "GUI thread stalled for" << stall.durationMs << "ms in phase"
+                         << stall.phase << (reportPath.isEmpty() ? "" : "- report")
+                         << reportPath;
+        }
+
+        msleep(PingIntervalMs);
+    }
+}
+
+void StallWatchdog::sample(Stall& stall)
+{
+    Tracer::Phase phase = Tracer::currentPhase(m_guiThreadId);
+    stall.phase = QString::fromLatin1(Tracer::phaseName(phase));
+
+#ifdef STALL_WATCHDOG_BACKTRACE
+    // libssh treats an interrupted poll() as a failed connection, so leave a thread in
+    // a blocking connect alone; the phase already says where it is
+    if (phase == Tracer::Connect) {
+        stall.backtraceNote = "skipped during blocking connect";
+        return;
+    }
+
+    s_frameCount.storeRelease(-1);
+    if (pthread_kill(s_guiThread, BacktraceSignal) != 0) {
+        stall.backtraceNote = "cannot signal the GUI thread";
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int frameCount = -1;
+    while ((frameCount = s_frameCount.loadAcquire()) < 0 && timer.elapsed() < BacktraceTimeoutMs) {
+        usleep(1000);
+    }
+    if (frameCount < 0) {
+        // Signals stay blocked in some system calls; the phase is all we have
+        stall.backtraceNote = "GUI thread did not respond to the backtrace signal";
+        return;
+    }
+
+    char** symbols = backtrace_symbols(s_frames, frameCount);
+    if (!symbols) {
+        stall.backtraceNote = "cannot resolve symbols";
+        return;
+    }
+    // Frame 0 is the signal handler and frame 1 the signal trampoline
+    for (int i = 2; i < frameCount; ++i) {
+        stall.backtrace << QString::fromLocal8Bit(symbols[i]);
+    }
+    free(symbols);
+#else
+    stall.backtraceNote = "backtraces are not supported on this platform";
+#endif
+}
+
+QString StallWatchdog::writeReport(const Stall& stall)
+{
+    QDir().mkpath(m_reportDirectory);
+    const QDateTime now = QDateTime::currentDateTime();
+    const QString path = m_reportDirectory + "/stall-" +
+                         now.toString("yyyyMMdd-HHmmss-zzz") + ".json";
+
+    QByteArray json = "{\"type\":\"gui_stall\",\"timestamp\":";
+    json += jsonString(now.toString(Qt::ISODateWithMs));
+    json += ",\"duration_ms\":" + QByteArray::number(stall.durationMs);
+    json += ",\"threshold_ms\":" + QByteArray::number(m_thresholdMs);
+    json += ",\"phase\":" + jsonString(stall.phase);
+    json += ",\"backtrace\":[";
+    for (int i = 0; i < stall.backtrace.size(); ++i) {
+        if (i > 0) {
+            json += ',';
+        }
+        json += "\n  " + jsonString(stall.backtrace[i]);
+    }
+    json += "]";
+    if (!stall.backtraceNote.isEmpty()) {
+        json += ",\"backtrace_note\":" + jsonString(stall.backtraceNote);
+    }
+    json += "}\n";
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) < 0) {
+        qWarning(ui) << "Cannot write stall report" << path << file.errorString();
+        return QString();
+    }
+    return path;
+}
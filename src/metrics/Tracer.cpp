@@ -0,0 +1,327 @@
+#include "Tracer.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Per-thread event ring. Only the owning thread writes. A span that began before
+// recording was turned off can still be writing when an export or clear() starts, so
+// writes are bracketed by a sequence number (odd while writing) and the exporter
+// copies a ring again if it changed underneath.
+struct TraceBuffer {
+    struct Event {
+        quint64 startNs;
+        quint64 durationNs;
+        int phase;
+    };
+
+    // Owner; cleared when the thread ends. Guarded by the registry mutex.
+    Qt::HANDLE threadId = nullptr;
+    int tid = 0;
+    QString name;
+    bool finished = false;
+
+    QAtomicInteger<int> phase{Tracer::Idle};
+    QAtomicInteger<quint64> written{0};
+    QAtomicInteger<quint64> sequence{0};
+    // Events before this count were dropped by clear(); written itself is the owner's
+    QAtomicInteger<quint64> exportFrom{0};
+    QAtomicPointer<Event> events{nullptr};
+    std::unique_ptr<Event[]> storage;
+
+    void record(Tracer::Phase eventPhase, quint64 startNs, quint64 durationNs)
+    {
+        // Checked again: an export may have turned recording off since the span began
+        if (!Tracer::isEnabled()) {
+            return;
+        }
+
+        Event* ring = events.loadRelaxed();
+        if (!ring) {
+            // Allocated on the first recorded span so idle threads cost nothing
+            storage.reset(new Event[Tracer::EventsPerThread]);
+            ring = storage.get();
+            events.storeRelease(ring);
+        }
+
+        const quint64 index = written.loadRelaxed();
+        const quint64 seq = sequence.loadRelaxed();
+        sequence.storeRelaxed(seq + 1);
+        std::atomic_thread_fence(std::memory_order_release);
+        ring[index % Tracer::EventsPerThread] = {startNs, durationNs, eventPhase};
+        written.storeRelaxed(index + 1);
+        sequence.storeRelease(seq + 2);
+    }
+
+    // Events still in the ring and not cleared, oldest first
+    std::vector<Event> snapshot() const
+    {
+        std::vector<Event> copy;
+        while (true) {
+            const quint64 seq = sequence.loadAcquire();
+            if (seq & 1) {
+                QThread::yieldCurrentThread();
+                continue;
+            }
+
+            copy.clear();
+            const Event* ring = events.loadAcquire();
+            const quint64 end = written.loadRelaxed();
+            const quint64 kept = qMin<quint64>(end, Tracer::EventsPerThread);
+            const quint64 begin = qMax(end - kept, qMin(exportFrom.loadRelaxed(), end));
+            if (ring) {
+                copy.reserve(end - begin);
+                for (quint64 i = begin; i < end; ++i) {
+                    copy.push_back(ring[i % Tracer::EventsPerThread]);
+                }
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.loadRelaxed() == seq) {
+                return copy;
+            }
+        }
+    }
+};
+
+namespace {
+
+// A thread's buffer outlives it so its events can still be exported after a tab
+// closed, until a new thread takes the buffer over. Memory is therefore bounded by the
+// most threads ever tracing at once rather than by every thread ever started.
+struct TraceRegistry {
+    QMutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    int nextTid = 1;
+};
+
+TraceRegistry& registry()
+{
+    static TraceRegistry instance;
+    return instance;
+}
+
+// Hands the thread's buffer back to the registry when the thread ends
+struct ThreadBufferHandle {
+    TraceBuffer* buffer = nullptr;
+
+    ~ThreadBufferHandle()
+    {
+        if (!buffer) {
+            return;
+        }
+        TraceRegistry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        buffer->threadId = nullptr;
+        buffer->finished = true;
+        buffer->phase.storeRelaxed(Tracer::Idle);
+    }
+};
+
+void appendEscaped(QByteArray& out, const QString& text)
+{
+    for (QChar ch : text) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += static_cast<char>(ch.unicode());
+        } else if (ch.unicode() < 0x20) {
+            out += ' ';
+        } else {
+            out += QString(ch).toUtf8();
+        }
+    }
+}
+
+} // namespace
+
+QAtomicInt Tracer::s_enabled(0);
+
+void Tracer::setEnabled(bool enabled)
+{
+    s_enabled.storeRelaxed(enabled ? 1 : 0);
+}
+
+Tracer::Phase Tracer::currentPhase(Qt::HANDLE threadId)
+{
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    // Thread ids are reused once a thread ends. Finished threads give theirs up, and
+    // should one have ended without doing so, the newest owner of the id wins.
+    const TraceBuffer* owner = nullptr;
+    for (const auto& buffer : reg.buffers) {
+        if (buffer->threadId == threadId && (!owner || buffer->tid > owner->tid)) {
+            owner = buffer.get();
+        }
+    }
+    return owner ? static_cast<Phase>(owner->phase.loadRelaxed()) : Idle;
+}
+
+const char* Tracer::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Idle:
+        return "idle";
+    case Read:
+        return "read";
+    case Decode:
+        return "decode";
+    case Parse:
+        return "parse";
+    case ScreenUpdate:
+        return "screen_update";
+    case Paint:
+        return "paint";
+    case Write:
+        return "write";
+    case Connect:
+        return "connect";
+    case PhaseCount:
+        break;
+    }
+    return "unknown";
+}
+
+quint64 Tracer::now()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+}
+
+TraceBuffer* Tracer::threadBuffer()
+{
+    thread_local ThreadBufferHandle handle;
+    if (handle.buffer) {
+        return handle.buffer;
+    }
+
+    QString name;
+    QThread* thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        name = "GUI";
+    } else if (!thread->objectName().isEmpty()) {
+        name = thread->objectName();
+    } else {
+        name = thread->metaObject()->className();
+    }
+
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    // Take over a finished thread's buffer, ring included, before allocating a new one
+    TraceBuffer* buffer = nullptr;
+    for (const auto& candidate : reg.buffers) {
+        if (candidate->finished) {
+            buffer = candidate.get();
+            break;
+        }
+    }
+    if (buffer) {
+        buffer->written.storeRelease(0);
+        buffer->exportFrom.storeRelaxed(0);
+        buffer->finished = false;
+    } else {
+        reg.buffers.push_back(std::make_unique<TraceBuffer>());
+        buffer = reg.buffers.back().get();
+    }
+
+    // A fresh tid keeps the new thread's events apart from the old owner's in viewers
+    buffer->threadId = QThread::currentThreadId();
+    buffer->tid = reg.nextTid++;
+    buffer->name = name;
+    handle.buffer = buffer;
+    return buffer;
+}
+
+QByteArray Tracer::exportChromeTrace()
+{
+    // Pause recording so owners stop adding events; one they are in the middle of
+    // writing makes snapshot() copy that ring again
+    bool wasEnabled = isEnabled();
+    setEnabled(false);
+
+    QByteArray out;
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&out, &first]() {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+
+    {
+        TraceRegistry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        for (const auto& buffer : reg.buffers) {
+            separator();
+            out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":";
+            out += QByteArray::number(buffer->tid);
+            out += ",\"args\":{\"name\":\"";
+            appendEscaped(out, buffer->name);
+            out += "\"}}";
+
+            for (const TraceBuffer::Event& event : buffer->snapshot()) {
+                separator();
+                out += "{\"ph\":\"X\",\"cat\":\"pipeline\",\"name\":\"";
+                out += phaseName(static_cast<Phase>(event.phase));
+                out += "\",\"pid\":1,\"tid\":";
+                out += QByteArray::number(buffer->tid);
+                // Chrome trace timestamps are microseconds
+                out += ",\"ts\":";
+                out += QByteArray::number(event.startNs / 1000.0, 'f', 3);
+                out += ",\"dur\":";
+                out += QByteArray::number(event.durationNs / 1000.0, 'f', 3);
+                out += "}";
+            }
+        }
+    }
+
+    out += "]}\n";
+    setEnabled(wasEnabled);
+    return out;
+}
+
+bool Tracer::writeChromeTrace(const QString& path, QString* errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+
+    file.write(exportChromeTrace());
+    return true;
+}
+
+void Tracer::clear()
+{
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        buffer->exportFrom.storeRelaxed(buffer->written.loadAcquire());
+    }
+}
+
+void Tracer::Span::begin()
+{
+    m_buffer = Tracer::threadBuffer();
+    m_previous = static_cast<Phase>(m_buffer->phase.fetchAndStoreRelaxed(m_phase));
+    m_startNs = Tracer::isEnabled() ? Tracer::now() : 0;
+}
+
+void Tracer::Span::end()
+{
+    if (m_startNs != 0) {
+        m_buffer->record(m_phase, m_startNs, Tracer::now() - m_startNs);
+    }
+    m_buffer->phase.storeRelaxed(m_previous);
+}
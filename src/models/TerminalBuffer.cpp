@@ -2,12 +2,14 @@
 #include <algorithm>
 
 TerminalBuffer::TerminalBuffer()
-    : m_rows(24), m_columns(80), m_maxScrollback(10000), m_cursorRow(0), m_cursorColumn(0)
+    : m_head(0), m_count(0), m_rows(24), m_columns(80), m_maxScrollback(10000), m_cursorRow(0),
+      m_cursorColumn(0)
 {
 }
 
 TerminalBuffer::TerminalBuffer(int rows, int columns)
-    : m_rows(rows), m_columns(columns), m_maxScrollback(10000), m_cursorRow(0), m_cursorColumn(0)
+    : m_head(0), m_count(0), m_rows(rows), m_columns(columns), m_maxScrollback(10000),
+      m_cursorRow(0), m_cursorColumn(0)
 {
 }
 
@@ -38,23 +40,39 @@ void TerminalBuffer::setDimensions(int rows, int columns)
 void TerminalBuffer::appendLine(const QString& line)
 {
     if (line.length() <= m_columns) {
-        m_buffer.append(line);
+        pushLine(line);
     } else {
         // Handle line wrapping
         int offset = 0;
         while (offset < line.length()) {
-            m_buffer.append(wrapLine(line, offset));
+            pushLine(wrapLine(line, offset));
             offset += m_columns;
         }
     }
+}
+
+void TerminalBuffer::pushLine(const QString& line)
+{
+    if (m_maxScrollback <= 0) {
+        return;
+    }
 
-    enforceScrollbackLimit();
+    if (m_lines.size() < m_maxScrollback) {
+        // Still filling up: the ring has not wrapped yet and m_head stays 0
+        m_lines.append(line);
+        m_count = m_lines.size();
+        return;
+    }
+
+    // Full: overwrite the oldest line
+    m_lines[m_head] = line;
+    m_head = (m_head + 1) % m_lines.size();
 }
 
 QString TerminalBuffer::getLine(int index) const
 {
-    if (index >= 0 && index < m_buffer.size()) {
-        return m_buffer[index];
+    if (index >= 0 && index < m_count) {
+        return m_lines[physicalIndex(index)];
     }
     return QString();
 }
@@ -62,10 +80,9 @@ QString TerminalBuffer::getLine(int index) const
 QVector<QString> TerminalBuffer::getVisibleLines() const
 {
     QVector<QString> visible;
-    int start = std::max(0, static_cast<int>(m_buffer.size()) - m_rows);
-
-    for (int i = start; i < m_buffer.size(); i++) {
-        visible.append(m_buffer[i]);
+    visible.reserve(m_rows);
+    for (const QString& line : visibleLines()) {
+        visible.append(line);
     }
 
     // Pad with empty lines if needed
@@ -78,12 +95,56 @@ QVector<QString> TerminalBuffer::getVisibleLines() const
 
 QVector<QString> TerminalBuffer::getScrollbackBuffer() const
 {
-    return m_buffer;
+    if (m_head == 0) {
+        return m_lines;
+    }
+
+    QVector<QString> lines;
+    lines.reserve(m_count);
+    for (const QString& line : scrollback()) {
+        lines.append(line);
+    }
+    return lines;
+}
+
+TerminalBuffer::LineRange TerminalBuffer::lines(int first, int count) const
+{
+    first = std::clamp(first, 0, m_count);
+    count = std::clamp(count, 0, m_count - first);
+    return LineRange(this, first, count);
+}
+
+TerminalBuffer::LineRange TerminalBuffer::visibleLines() const
+{
+    int count = std::min(m_count, std::max(0, m_rows));
+    return LineRange(this, m_count - count, count);
+}
+
+TerminalBuffer::LineRange::Segment TerminalBuffer::LineRange::firstSegment() const
+{
+    if (m_count == 0) {
+        return Segment();
+    }
+    int start = m_buffer->physicalIndex(m_first);
+    int capacity = m_buffer->m_lines.size();
+    return {m_buffer->m_lines.constData() + start, std::min(m_count, capacity - start)};
+}
+
+TerminalBuffer::LineRange::Segment TerminalBuffer::LineRange::secondSegment() const
+{
+    Segment first = firstSegment();
+    if (first.size == m_count) {
+        return Segment();
+    }
+    // The rest wrapped around to the start of storage
+    return {m_buffer->m_lines.constData(), m_count - first.size};
 }
 
 void TerminalBuffer::clear()
 {
-    m_buffer.clear();
+    m_lines.clear();
+    m_head = 0;
+    m_count = 0;
     m_cursorRow = 0;
     m_cursorColumn = 0;
     m_selection = SelectionRange();
@@ -91,18 +152,29 @@ void TerminalBuffer::clear()
 
 bool TerminalBuffer::isEmpty() const
 {
-    return m_buffer.isEmpty();
+    return m_count == 0;
 }
 
 int TerminalBuffer::lineCount() const
 {
-    return m_buffer.size();
+    return m_count;
 }
 
 void TerminalBuffer::setMaxScrollback(int lines)
 {
     m_maxScrollback = lines;
-    enforceScrollbackLimit();
+
+    // Unroll into a new ring holding the newest lines that still fit
+    int keep = std::min(m_count, std::max(0, lines));
+    QVector<QString> kept;
+    kept.reserve(keep);
+    for (int i = m_count - keep; i < m_count; i++) {
+        kept.append(m_lines[physicalIndex(i)]);
+    }
+
+    m_lines.swap(kept);
+    m_head = 0;
+    m_count = keep;
 }
 
 int TerminalBuffer::maxScrollback() const
@@ -129,7 +201,7 @@ void TerminalBuffer::setCursorPosition(int row, int column)
 void TerminalBuffer::startSelection(int row, int column)
 {
     m_selection.active = true;
-    m_selection.startRow = std::clamp(row, 0, static_cast<int>(m_buffer.size()) - 1);
+    m_selection.startRow = std::clamp(row, 0, std::max(0, m_count - 1));
     m_selection.startColumn = std::clamp(column, 0, m_columns - 1);
     m_selection.endRow = m_selection.startRow;
     m_selection.endColumn = m_selection.startColumn;
@@ -138,7 +210,7 @@ void TerminalBuffer::startSelection(int row, int column)
 void TerminalBuffer::updateSelection(int row, int column)
 {
     if (m_selection.active) {
-        m_selection.endRow = std::clamp(row, 0, static_cast<int>(m_buffer.size()) - 1);
+        m_selection.endRow = std::clamp(row, 0, std::max(0, m_count - 1));
         m_selection.endColumn = std::clamp(column, 0, m_columns - 1);
     }
 }
@@ -199,13 +271,6 @@ bool TerminalBuffer::hasSelection() const
     return m_selection.active;
 }
 
-void TerminalBuffer::enforceScrollbackLimit()
-{
-    while (m_buffer.size() > m_maxScrollback) {
-        m_buffer.removeFirst();
-    }
-}
-
 QString TerminalBuffer::wrapLine(const QString& line, int offset)
 {
     return line.mid(offset, m_columns);
@@ -0,0 +1,338 @@
+#include "LocalPtySession.h"
+#include "AllocTracker.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <QStandardPaths>
+#include <QtGlobal>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#if defined(Q_OS_MACOS) || defined(Q_OS_IOS)
+#include <util.h>
+#elif defined(Q_OS_FREEBSD)
+#include <libutil.h>
+#else
+#include <pty.h>
+#endif
+
+extern char** environ;
+#endif
+
+namespace {
+constexpr int ReadChunkSize = 16384;
+constexpr int PollTimeout = 50;
+constexpr char TermType[] = "xterm-256color";
+} // namespace
+
+LocalPtySession::LocalPtySession(const QString& program, const QStringList& arguments,
+                                 QObject* parent)
+    : TerminalSession(parent), m_program(program), m_arguments(arguments), m_masterFd(-1),
+      m_wakePipe{-1, -1}, m_childPid(-1), m_exitStatus(-1)
+{
+#ifdef Q_OS_UNIX
+    // Self-pipe used by interruptIo() to break out of poll() when input is queued
+    if (::pipe(m_wakePipe) == 0) {
+        for (int fd : m_wakePipe) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+    }
+#endif
+}
+
+LocalPtySession::~LocalPtySession()
+{
+    stop();
+    wait();
+    cleanup();
+
+#ifdef Q_OS_UNIX
+    for (int fd : m_wakePipe) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+}
+
+bool LocalPtySession::isSupported()
+{
+#ifdef Q_OS_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LocalPtySession::interruptIo()
+{
+#ifdef Q_OS_UNIX
+    if (m_wakePipe[1] >= 0) {
+        char byte = 1;
+        ssize_t ignored = ::write(m_wakePipe[1], &byte, 1);
+        Q_UNUSED(ignored);
+    }
+#endif
+}
+
+void LocalPtySession::run()
+{
+    // Everything this thread allocates is transport work
+    ALLOC_SCOPE(Io);
+
+#ifdef Q_OS_UNIX
+    int rows;
+    int cols;
+    terminalSize(rows, cols);
+
+    if (!startChild(rows, cols)) {
+        return;
+    }
+
+    // Main I/O loop
+    while (!isStopRequested()) {
+        processWriteQueue();
+        processResize();
+
+        // Stop reading while the consumer is behind; the child blocks once the
+        // kernel PTY buffer is full
+        if (updateThrottleState()) {
+            waitForDrain();
+            continue;
+        }
+
+        if (!readOutput()) {
+            break;
+        }
+    }
+
+    cleanup();
+#else
+    emit error("Local terminal sessions are not supported on this platform");
+#endif
+}
+
+bool LocalPtySession::startChild(int rows, int cols)
+{
+#ifdef Q_OS_UNIX
+    QString program = m_program;
+    if (program.isEmpty()) {
+        program = QString::fromLocal8Bit(qgetenv("SHELL"));
+        if (program.isEmpty()) {
+            program = "/bin/sh";
+        }
+    }
+
+    QString executable = QStandardPaths::findExecutable(program);
+    if (executable.isEmpty()) {
+        emit error("Program not found: " + program);
+        return false;
+    }
+
+    // Everything the child needs is prepared before forking; after fork() only
+    // async-signal-safe calls are made
+    QList<QByteArray> argStorage;
+    argStorage.append(program.toLocal8Bit());
+    for (const QString& argument : m_arguments) {
+        argStorage.append(argument.toLocal8Bit());
+    }
+    std::vector<char*> argv;
+    for (QByteArray& arg : argStorage) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    QByteArray termEntry = QByteArray("TERM=") + TermType;
+    std::vector<char*> envp;
+    for (char** entry = environ; entry && *entry; ++entry) {
+        if (std::strncmp(*entry, "TERM=", 5) != 0) {
+            envp.push_back(*entry);
+        }
+    }
+    envp.push_back(termEntry.data());
+    envp.push_back(nullptr);
+
+    QByteArray path = executable.toLocal8Bit();
+
+    struct winsize size = {};
+    size.ws_row = static_cast<unsigned short>(rows);
+    size.ws_col = static_cast<unsigned short>(cols);
+
+    pid_t pid = ::forkpty(&m_masterFd, nullptr, nullptr, &size);
+    if (pid < 0) {
+        emit error(QString("forkpty failed: %1").arg(QString::fromLocal8Bit(std::strerror(errno))));
+        m_masterFd = -1;
+        return false;
+    }
+
+    if (pid == 0) {
+        ::execve(path.constData(), argv.data(), envp.data());
+        ::_exit(127);
+    }
+
+    m_childPid = pid;
+    ::fcntl(m_masterFd, F_SETFL, ::fcntl(m_masterFd, F_GETFL) | O_NONBLOCK);
+    ::fcntl(m_masterFd, F_SETFD, FD_CLOEXEC);
+
+    qInfo(terminal) << "Local session started:" << executable << "pid" << pid;
+    return true;
+#else
+    Q_UNUSED(rows);
+    Q_UNUSED(cols);
+    return false;
+#endif
+}
+
+bool LocalPtySession::readOutput()
+{
+#ifdef Q_OS_UNIX
+    struct pollfd fds[2];
+    fds[0].fd = m_masterFd;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = m_wakePipe[0];
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+
+    // Also wake up when a partially written chunk can make progress
+    if (!m_pendingWrite.isEmpty()) {
+        fds[0].events |= POLLOUT;
+    }
+
+    int rc = ::poll(fds, m_wakePipe[0] >= 0 ? 2 : 1, PollTimeout);
+    if (rc < 0) {
+        return errno == EINTR;
+    }
+
+    if (rc > 0 && (fds[1].revents & POLLIN)) {
+        char drain[64];
+        while (::read(m_wakePipe[0], drain, sizeof(drain)) > 0) {
+        }
+    }
+
+    if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+        QByteArray buffer(ReadChunkSize, '\0');
+        // The span also covers the errno checks below so that nothing can clobber errno
+        TRACE_SPAN(Read);
+        ssize_t nbytes = ::read(m_masterFd, buffer.data(), buffer.size());
+        notifyRead();
+
+        if (nbytes > 0) {
+            buffer.resize(static_cast<int>(nbytes));
+            deliverData(buffer);
+        } else if (nbytes == 0 || (errno != EAGAIN && errno != EINTR)) {
+            // Linux reports EIO once the child side of the PTY is closed
+            emit disconnected();
+            return false;
+        }
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LocalPtySession::processWriteQueue()
+{
+#ifdef Q_OS_UNIX
+    if (m_masterFd < 0) {
+        return;
+    }
+
+    // Never block on a full PTY: the child may itself be blocked writing output we
+    // have not read yet, so unwritten data is carried over to the next iteration
+    while (true) {
+        if (m_pendingWrite.isEmpty() && !takeWrite(m_pendingWrite)) {
+            return;
+        }
+
+        TRACE_SPAN(Write);
+        ssize_t written = ::write(m_masterFd, m_pendingWrite.constData(), m_pendingWrite.size());
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                return;
+            }
+            emit error(QString("Failed to write to local terminal: %1")
+                           .arg(QString::fromLocal8Bit(std::strerror(errno))));
+            m_pendingWrite.clear();
+            return;
+        }
+
+        notifyWritten(written);
+        m_pendingWrite.remove(0, static_cast<int>(written));
+        if (!m_pendingWrite.isEmpty()) {
+            return;
+        }
+    }
+#endif
+}
+
+void LocalPtySession::processResize()
+{
+#ifdef Q_OS_UNIX
+    int rows;
+    int cols;
+    if (!takePendingResize(rows, cols) || m_masterFd < 0) {
+        return;
+    }
+
+    // The kernel delivers SIGWINCH to the foreground process group
+    struct winsize size = {};
+    size.ws_row = static_cast<unsigned short>(rows);
+    size.ws_col = static_cast<unsigned short>(cols);
+    if (::ioctl(m_masterFd, TIOCSWINSZ, &size) < 0) {
+        qWarning(terminal) << "Window change failed:" << std::strerror(errno);
+    }
+#endif
+}
+
+void LocalPtySession::cleanup()
+{
+#ifdef Q_OS_UNIX
+    if (m_masterFd >= 0) {
+        ::close(m_masterFd);
+        m_masterFd = -1;
+    }
+
+    if (m_childPid > 0) {
+        pid_t pid = static_cast<pid_t>(m_childPid);
+        int status = 0;
+
+        // Closing the master hangs up the child; give it a moment before forcing it
+        ::kill(pid, SIGHUP);
+        pid_t result = 0;
+        for (int attempt = 0; attempt < 20 && result == 0; ++attempt) {
+            result = ::waitpid(pid, &status, WNOHANG);
+            if (result == 0) {
+                msleep(10);
+            }
+        }
+        if (result == 0) {
+            ::kill(pid, SIGKILL);
+            result = ::waitpid(pid, &status, 0);
+        }
+
+        if (result == pid && WIFEXITED(status)) {
+            m_exitStatus = WEXITSTATUS(status);
+        }
+        qInfo(terminal) << "Local session ended, pid" << m_childPid << "exit status"
+                        << m_exitStatus;
+        m_childPid = -1;
+    }
+#endif
+
+    m_pendingWrite.clear();
+    clearWriteQueue();
+}
@@ -0,0 +1,240 @@
+#include "TerminalSession.h"
+#include "LatencyTracker.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <QMutexLocker>
+
+TerminalSession::TerminalSession(QObject* parent)
+    : QThread(parent), m_stopRequested(false), m_rows(24), m_cols(80), m_resizePending(false),
+      m_pendingBytes(0), m_highWatermark(DefaultHighWatermark),
+      m_lowWatermark(DefaultLowWatermark), m_throttled(0), m_backpressureCount(0),
+      m_latencyTracker(nullptr), m_metrics(nullptr)
+{
+}
+
+TerminalSession::~TerminalSession()
+{
+}
+
+void TerminalSession::stop()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopRequested = true;
+        m_wakeCondition.wakeAll();
+    }
+    interruptIo();
+}
+
+void TerminalSession::writeData(const QString& data)
+{
+    writeData(data.toUtf8());
+}
+
+void TerminalSession::writeData(const QByteArray& data)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_writeQueue.enqueue(data);
+        if (SessionMetrics* metrics = m_metrics.loadAcquire()) {
+            metrics->writeQueueDepth.set(m_writeQueue.size());
+        }
+        m_wakeCondition.wakeOne();
+    }
+    interruptIo();
+}
+
+void TerminalSession::setTerminalSize(int rows, int cols)
+{
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (rows == m_rows && cols == m_cols) {
+            return;
+        }
+        m_rows = rows;
+        m_cols = cols;
+        m_resizePending = true;
+        m_wakeCondition.wakeOne();
+    }
+    interruptIo();
+}
+
+void TerminalSession::acknowledgeData(qint64 bytes)
+{
+    qint64 pending = m_pendingBytes.fetchAndAddOrdered(-bytes) - bytes;
+    if (pending < 0) {
+        m_pendingBytes.storeRelease(0);
+        pending = 0;
+    }
+
+    if (SessionMetrics* metrics = m_metrics.loadAcquire()) {
+        metrics->inboundPendingBytes.set(pending);
+    }
+
+    // Wake the reader as soon as the consumer has drained below the low watermark
+    if (m_throttled.loadAcquire() && pending <= m_lowWatermark.loadAcquire()) {
+        QMutexLocker locker(&m_mutex);
+        m_wakeCondition.wakeOne();
+    }
+}
+
+void TerminalSession::setInboundWatermarks(qint64 high, qint64 low)
+{
+    if (high <= 0) {
+        return;
+    }
+    m_highWatermark.storeRelease(high);
+    m_lowWatermark.storeRelease(qBound<qint64>(0, low, high));
+}
+
+qint64 TerminalSession::pendingInboundBytes() const
+{
+    return m_pendingBytes.loadAcquire();
+}
+
+bool TerminalSession::isThrottled() const
+{
+    return m_throttled.loadAcquire() != 0;
+}
+
+int TerminalSession::backpressureCount() const
+{
+    return m_backpressureCount.loadAcquire();
+}
+
+bool TerminalSession::isStopRequested()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stopRequested;
+}
+
+void TerminalSession::requestStop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stopRequested = true;
+}
+
+void TerminalSession::terminalSize(int& rows, int& cols)
+{
+    QMutexLocker locker(&m_mutex);
+    rows = m_rows;
+    cols = m_cols;
+    m_resizePending = false;
+}
+
+bool TerminalSession::takePendingResize(int& rows, int& cols)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_resizePending) {
+        return false;
+    }
+    rows = m_rows;
+    cols = m_cols;
+    m_resizePending = false;
+    return true;
+}
+
+bool TerminalSession::takeWrite(QByteArray& data)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_writeQueue.isEmpty()) {
+        return false;
+    }
+    data = m_writeQueue.dequeue();
+    if (SessionMetrics* metrics = m_metrics.loadAcquire()) {
+        metrics->writeQueueDepth.set(m_writeQueue.size());
+    }
+    return true;
+}
+
+void TerminalSession::clearWriteQueue()
+{
+    QMutexLocker locker(&m_mutex);
+    m_writeQueue.clear();
+    if (SessionMetrics* metrics = m_metrics.loadAcquire()) {
+        metrics->writeQueueDepth.set(0);
+    }
+}
+
+void TerminalSession::setLatencyTracker(LatencyTracker* tracker)
+{
+    m_latencyTracker.storeRelease(tracker);
+}
+
+void TerminalSession::setMetrics(SessionMetrics* metrics)
+{
+    m_metrics.storeRelease(metrics);
+}
+
+void TerminalSession::deliverData(const QByteArray& data)
+{
+    if (LatencyTracker* tracker = m_latencyTracker.loadAcquire()) {
+        tracker->markEcho();
+    }
+
+    qint64 pending = m_pendingBytes.fetchAndAddOrdered(data.size()) + data.size();
+    if (SessionMetrics* metrics = m_metrics.loadAcquire()) {
+        metrics->bytesIn.add(data.size());
+        metrics->inboundPendingBytes.set(pending);
+    }
+    emit dataReceived(data);
+}
+
+void TerminalSession::notifyRead()
+{
+    if (SessionMetrics* metrics = m_metrics.loadAcquire()) {
+        metrics->readCalls.add();
+    }
+}
+
+void TerminalSession::notifyWritten(qint64 bytes)
+{
+    if (LatencyTracker* tracker = m_latencyTracker.loadAcquire()) {
+        tracker->markWrite();
+    }
+    if (SessionMetrics* metrics = m_metrics.loadAcquire()) {
+        metrics->bytesOut.add(bytes);
+        metrics->writeCalls.add();
+    }
+}
+
+bool TerminalSession::updateThrottleState()
+{
+    qint64 pending = m_pendingBytes.loadAcquire();
+
+    if (!m_throttled.loadAcquire()) {
+        if (pending < m_highWatermark.loadAcquire()) {
+            return false;
+        }
+        m_throttled.storeRelease(1);
+        int count = m_backpressureCount.fetchAndAddOrdered(1) + 1;
+        qDebug(terminal) << "Inbound backpressure engaged," << pending
+                         << "bytes pending, count" << count;
+        emit backpressureChanged(true);
+        return true;
+    }
+
+    if (pending > m_lowWatermark.loadAcquire()) {
+        return true;
+    }
+
+    m_throttled.storeRelease(0);
+    qDebug(terminal) << "Inbound backpressure released," << pending << "bytes pending";
+    emit backpressureChanged(false);
+    return false;
+}
+
+void TerminalSession::waitForDrain()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_stopRequested || m_resizePending || !m_writeQueue.isEmpty()) {
+        return;
+    }
+    // Woken by acknowledgeData(), writeData(), setTerminalSize() or stop(); the
+    // timeout keeps end-of-stream detection responsive
+    m_wakeCondition.wait(&m_mutex, 50);
+}
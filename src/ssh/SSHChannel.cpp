@@ -89,6 +89,22 @@ bool SSHChannel::requestPty(int rows, int cols, const QString& termType)
     return true;
 }
 
+bool SSHChannel::changePtySize(int rows, int cols)
+{
+    if (!isOpen()) {
+        m_lastError = "Channel is not open";
+        return false;
+    }
+
+    int rc = ssh_channel_change_pty_size(m_channel, cols, rows);
+    if (rc != SSH_OK) {
+        m_lastError = QString("Failed to change PTY size: %1").arg(ssh_get_error(m_session));
+        return false;
+    }
+
+    return true;
+}
+
 int SSHChannel::write(const QString& data)
 {
     return write(data.toUtf8());
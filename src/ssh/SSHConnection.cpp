@@ -1,6 +1,7 @@
 #include "SSHConnection.h"
 #include "SSHAuthenticator.h"
 #include "Logger.h"
+#include "Tracer.h"
 #include <QTimer>
 #include <QCoreApplication>
 
@@ -171,6 +172,10 @@ bool SSHConnection::waitForConnected(int timeout)
 
 void SSHConnection::handleConnectionResult()
 {
+    // Blocking libssh calls. The stall watchdog attributes GUI freezes to this phase
+    // and must not interrupt poll() here, so it is published even without tracing.
+    TRACE_PHASE(Connect);
+
     if (!performConnection()) {
         return; // Error already set
     }
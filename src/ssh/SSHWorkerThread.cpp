@@ -1,9 +1,10 @@
 #include "SSHWorkerThread.h"
-#include <QMutexLocker>
+#include "AllocTracker.h"
+#include "Logger.h"
+#include "Tracer.h"
 
 SSHWorkerThread::SSHWorkerThread(SSHConnection* connection, QObject* parent)
-    : QThread(parent), m_connection(connection), m_channel(nullptr), m_stopRequested(false),
-      m_running(false)
+    : TerminalSession(parent), m_connection(connection), m_channel(nullptr)
 {
 }
 
@@ -14,111 +15,116 @@ SSHWorkerThread::~SSHWorkerThread()
     cleanup();
 }
 
-void SSHWorkerThread::stop()
-{
-    QMutexLocker locker(&m_mutex);
-    m_stopRequested = true;
-    m_writeCondition.wakeAll();
-}
-
-void SSHWorkerThread::writeData(const QString& data)
-{
-    writeData(data.toUtf8());
-}
-
-void SSHWorkerThread::writeData(const QByteArray& data)
-{
-    QMutexLocker locker(&m_mutex);
-    m_writeQueue.enqueue(data);
-    m_writeCondition.wakeOne();
-}
-
 void SSHWorkerThread::run()
 {
-    m_running = true;
-    m_stopRequested = false;
+    // Everything this thread allocates is transport work
+    ALLOC_SCOPE(Io);
 
     if (!m_connection || !m_connection->isConnected()) {
         emit error("SSH connection not established");
-        m_running = false;
         return;
     }
 
     if (!initializeChannel()) {
         emit error("Failed to initialize SSH channel");
-        m_running = false;
         return;
     }
 
-    // Request PTY and shell
-    if (!m_channel->requestPty(24, 80)) {
+    // Request PTY at the current terminal size, then shell
+    int rows;
+    int cols;
+    terminalSize(rows, cols);
+
+    if (!m_channel->requestPty(rows, cols)) {
         emit error("Failed to request PTY");
         cleanup();
-        m_running = false;
         return;
     }
 
     if (!m_channel->requestShell()) {
         emit error("Failed to request shell");
         cleanup();
-        m_running = false;
         return;
     }
 
     // Main I/O loop
-    while (!m_stopRequested && m_running) {
-        // Process write queue
+    while (!isStopRequested()) {
+        // Process write queue and window-change requests
         processWriteQueue();
+        processResize();
 
-        // Read data with timeout
-        readLoop();
+        // Stop reading while the consumer is behind; unread data stays in the
+        // SSH channel window so the server stops sending
+        if (updateThrottleState()) {
+            waitForDrain();
+            continue;
+        }
 
-        // Small delay to prevent CPU spinning
-        msleep(10);
+        // Read data with timeout; only back off when the channel was idle
+        if (!readLoop()) {
+            msleep(10);
+        }
     }
 
     cleanup();
-    m_running = false;
 }
 
-void SSHWorkerThread::readLoop()
+bool SSHWorkerThread::readLoop()
 {
     if (!m_channel || !m_channel->isOpen()) {
-        return;
+        return false;
     }
 
     // Non-blocking read with short timeout
-    QByteArray data = m_channel->readBytes(4096, 50);
+    QByteArray data;
+    {
+        TRACE_SPAN(Read);
+        data = m_channel->readBytes(4096, 50);
+    }
+    notifyRead();
 
     if (!data.isEmpty()) {
-        emit dataReceived(data);
+        SLOG_DEBUG(sshConnection, "Channel read %1 bytes", data.size());
+        deliverData(data);
     }
 
     // Check for EOF or channel closed
     if (m_channel->isEof()) {
         emit disconnected();
-        m_stopRequested = true;
+        requestStop();
     }
+
+    return !data.isEmpty();
 }
 
 void SSHWorkerThread::processWriteQueue()
 {
-    QMutexLocker locker(&m_mutex);
-
     // Process all pending writes
-    while (!m_writeQueue.isEmpty()) {
-        QByteArray data = m_writeQueue.dequeue();
-
-        locker.unlock();
-
+    QByteArray data;
+    while (takeWrite(data)) {
         if (m_channel && m_channel->isOpen()) {
+            TRACE_SPAN(Write);
             int written = m_channel->write(data);
             if (written < 0) {
                 emit error("Failed to write data to SSH channel");
+            } else {
+                SLOG_DEBUG(sshConnection, "Channel wrote %1 of %2 bytes", written, data.size());
+                notifyWritten(written);
             }
         }
+    }
+}
+
+void SSHWorkerThread::processResize()
+{
+    int rows;
+    int cols;
+    if (!takePendingResize(rows, cols)) {
+        return;
+    }
 
-        locker.relock();
+    if (m_channel && m_channel->isOpen() && !m_channel->changePtySize(rows, cols)) {
+        qWarning(sshConnection) << "Window change failed:" << m_channel->lastError();
     }
 }
 
@@ -148,6 +154,5 @@ void SSHWorkerThread::cleanup()
     }
 
     // Clear write queue
-    QMutexLocker locker(&m_mutex);
-    m_writeQueue.clear();
+    clearWriteQueue();
 }
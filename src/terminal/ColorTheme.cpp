@@ -0,0 +1,150 @@
+#include "ColorPalette.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QtDebug>
+
+namespace {
+
+constexpr ColorPalette::BaseColors XtermColors = {{
+    qRgb(0, 0, 0), qRgb(205, 0, 0), qRgb(0, 205, 0), qRgb(205, 205, 0),
+    qRgb(0, 0, 238), qRgb(205, 0, 205), qRgb(0, 205, 205), qRgb(229, 229, 229),
+    qRgb(127, 127, 127), qRgb(255, 0, 0), qRgb(0, 255, 0), qRgb(255, 255, 0),
+    qRgb(92, 92, 255), qRgb(255, 0, 255), qRgb(0, 255, 255), qRgb(255, 255, 255),
+}};
+
+constexpr ColorPalette::BaseColors SolarizedColors = {{
+    qRgb(7, 54, 66), qRgb(220, 50, 47), qRgb(133, 153, 0), qRgb(181, 137, 0),
+    qRgb(38, 139, 210), qRgb(211, 54, 130), qRgb(42, 161, 152), qRgb(238, 232, 213),
+    qRgb(0, 43, 54), qRgb(203, 75, 22), qRgb(88, 110, 117), qRgb(101, 123, 131),
+    qRgb(131, 148, 150), qRgb(108, 113, 196), qRgb(147, 161, 161), qRgb(253, 246, 227),
+}};
+
+ColorTheme makeTheme(const QString& name, const ColorPalette::Palette& palette,
+                     QRgb foreground, QRgb background)
+{
+    ColorTheme theme;
+    theme.name = name;
+    theme.foreground = foreground;
+    theme.background = background;
+    theme.palette = palette;
+    return theme;
+}
+
+bool parseColor(const QJsonValue& value, QRgb& rgb)
+{
+    QColor color(value.toString());
+    if (!color.isValid()) {
+        return false;
+    }
+    rgb = color.rgb();
+    return true;
+}
+
+QVector<ColorTheme> loadThemes()
+{
+    constexpr ColorPalette::Palette xterm = ColorPalette::build(XtermColors);
+    constexpr ColorPalette::Palette solarized = ColorPalette::build(SolarizedColors);
+
+    QVector<ColorTheme> themes;
+    themes.append(makeTheme("Default", ColorPalette::Default, ColorPalette::Vga[7],
+                            ColorPalette::Vga[0]));
+    themes.append(makeTheme("xterm", xterm, XtermColors[7], XtermColors[0]));
+    themes.append(makeTheme("Solarized Dark", solarized, qRgb(131, 148, 150),
+                            qRgb(0, 43, 54)));
+
+    const QString dirPath =
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/themes";
+    const QFileInfoList files =
+        QDir(dirPath).entryInfoList(QStringList() << "*.json", QDir::Files, QDir::Name);
+    for (const QFileInfo& info : files) {
+        QFile file(info.filePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        ColorTheme theme;
+        QString error;
+        if (!ColorTheme::fromJson(file.readAll(), theme, &error)) {
+            qWarning() << "Ignoring colour theme" << info.filePath() << ":" << error;
+            continue;
+        }
+        if (theme.name.isEmpty()) {
+            theme.name = info.baseName();
+        }
+        themes.append(theme);
+    }
+    return themes;
+}
+
+} // namespace
+
+const ColorTheme& ColorTheme::defaultTheme()
+{
+    return available().first();
+}
+
+const QVector<ColorTheme>& ColorTheme::available()
+{
+    static const QVector<ColorTheme> themes = loadThemes();
+    return themes;
+}
+
+const ColorTheme* ColorTheme::find(const QString& name)
+{
+    for (const ColorTheme& theme : available()) {
+        if (theme.name == name) {
+            return &theme;
+        }
+    }
+    return nullptr;
+}
+
+bool ColorTheme::fromJson(const QByteArray& json, ColorTheme& theme, QString* error)
+{
+    auto fail = [error](const QString& message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (!document.isObject()) {
+        return fail(parseError.errorString());
+    }
+
+    const QJsonObject object = document.object();
+    const QJsonArray colors = object.value("colors").toArray();
+    if (colors.size() != 16) {
+        return fail("\"colors\" must list 16 colours");
+    }
+
+    ColorPalette::BaseColors base;
+    for (int i = 0; i < 16; ++i) {
+        if (!parseColor(colors.at(i), base[i])) {
+            return fail(QString("invalid colour at index %1").arg(i));
+        }
+    }
+
+    ColorTheme parsed;
+    parsed.name = object.value("name").toString();
+    parsed.palette = ColorPalette::build(base);
+    parsed.foreground = base[7];
+    parsed.background = base[0];
+    const QJsonValue foreground = object.value("foreground");
+    if (!foreground.isUndefined() && !parseColor(foreground, parsed.foreground)) {
+        return fail("invalid foreground colour");
+    }
+    const QJsonValue background = object.value("background");
+    if (!background.isUndefined() && !parseColor(background, parsed.background)) {
+        return fail("invalid background colour");
+    }
+
+    theme = parsed;
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "ControlScan.h"
+#include <QtAlgorithms>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONTROLSCAN_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 is compiled per function and only used after a CPUID check, so the rest of the
+// build keeps its baseline instruction set
+#if defined(CONTROLSCAN_SSE2) && defined(__GNUC__)
+#define CONTROLSCAN_AVX2
+#include <immintrin.h>
+#endif
+
+namespace Escape {
+
+namespace {
+
+template <typename CharT>
+inline bool isControl(CharT ch)
+{
+    const uint code = static_cast<uint>(ch);
+    return code < 0x20 || code == 0x7f;
+}
+
+template <typename CharT>
+const CharT* scanScalar(const CharT* pos, const CharT* end)
+{
+    while (pos < end && !isControl(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+#ifdef CONTROLSCAN_SSE2
+
+// A lane is a control character when saturating subtraction of 0x1f leaves 0 (the
+// value was <= 0x1f) or when it equals DEL. Works for any unsigned value, unlike a
+// signed compare.
+const char16_t* scan16Sse2(const char16_t* pos, const char16_t* end)
+{
+    const __m128i limit = _mm_set1_epi16(0x1f);
+    const __m128i del = _mm_set1_epi16(0x7f);
+    const __m128i zero = _mm_setzero_si128();
+    while (end - pos >= 8) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        const __m128i control = _mm_or_si128(
+            _mm_cmpeq_epi16(_mm_subs_epu16(chars, limit), zero), _mm_cmpeq_epi16(chars, del));
+        const uint mask = static_cast<uint>(_mm_movemask_epi8(control));
+        if (mask != 0) {
+            return pos + qCountTrailingZeroBits(mask) / 2;
+        }
+        pos += 8;
+    }
+    return scanScalar(pos, end);
+}
+
+const char* scan8Sse2(const char* pos, const char* end)
+{
+    const __m128i limit = _mm_set1_epi8(0x1f);
+    const __m128i del = _mm_set1_epi8(0x7f);
+    const __m128i zero = _mm_setzero_si128();
+    while (end - pos >= 16) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        const __m128i control = _mm_or_si128(
+            _mm_cmpeq_epi8(_mm_subs_epu8(chars, limit), zero), _mm_cmpeq_epi8(chars, del));
+        const uint mask = static_cast<uint>(_mm_movemask_epi8(control));
+        if (mask != 0) {
+            return pos + qCountTrailingZeroBits(mask);
+        }
+        pos += 16;
+    }
+    return scanScalar(pos, end);
+}
+
+#endif // CONTROLSCAN_SSE2
+
+#ifdef CONTROLSCAN_AVX2
+
+__attribute__((target("avx2")))
+const char16_t* scan16Avx2(const char16_t* pos, const char16_t* end)
+{
+    const __m256i limit = _mm256_set1_epi16(0x1f);
+    const __m256i del = _mm256_set1_epi16(0x7f);
+    const __m256i zero = _mm256_setzero_si256();
+    while (end - pos >= 16) {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        const __m256i control = _mm256_or_si256(
+            _mm256_cmpeq_epi16(_mm256_subs_epu16(chars, limit), zero),
+            _mm256_cmpeq_epi16(chars, del));
+        const uint mask = static_cast<uint>(_mm256_movemask_epi8(control));
+        if (mask != 0) {
+            return pos + qCountTrailingZeroBits(mask) / 2;
+        }
+        pos += 16;
+    }
+    return scan16Sse2(pos, end);
+}
+
+__attribute__((target("avx2")))
+const char* scan8Avx2(const char* pos, const char* end)
+{
+    const __m256i limit = _mm256_set1_epi8(0x1f);
+    const __m256i del = _mm256_set1_epi8(0x7f);
+    const __m256i zero = _mm256_setzero_si256();
+    while (end - pos >= 32) {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        const __m256i control = _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_subs_epu8(chars, limit), zero),
+            _mm256_cmpeq_epi8(chars, del));
+        const uint mask = static_cast<uint>(_mm256_movemask_epi8(control));
+        if (mask != 0) {
+            return pos + qCountTrailingZeroBits(mask);
+        }
+        pos += 32;
+    }
+    return scan8Sse2(pos, end);
+}
+
+#endif // CONTROLSCAN_AVX2
+
+const ControlScanner& dispatch()
+{
+    static const ControlScanner selected = controlScanImplementations().first();
+    return selected;
+}
+
+} // namespace
+
+const char16_t* findControl(const char16_t* pos, const char16_t* end)
+{
+    return dispatch().scan16(pos, end);
+}
+
+const char* findControl(const char* pos, const char* end)
+{
+    return dispatch().scan8(pos, end);
+}
+
+const char16_t* findControlScalar(const char16_t* pos, const char16_t* end)
+{
+    return scanScalar(pos, end);
+}
+
+const char* findControlScalar(const char* pos, const char* end)
+{
+    return scanScalar(pos, end);
+}
+
+const char* controlScanImplementation()
+{
+    return dispatch().name;
+}
+
+QVector<ControlScanner> controlScanImplementations()
+{
+    QVector<ControlScanner> scanners;
+#ifdef CONTROLSCAN_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scanners.append(ControlScanner{"avx2", scan16Avx2, scan8Avx2});
+    }
+#endif
+#ifdef CONTROLSCAN_SSE2
+    scanners.append(ControlScanner{"sse2", scan16Sse2, scan8Sse2});
+#endif
+    scanners.append(ControlScanner{"scalar", scanScalar<char16_t>, scanScalar<char>});
+    return scanners;
+}
+
+} // namespace Escape
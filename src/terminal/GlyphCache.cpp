@@ -0,0 +1,218 @@
+#include "GlyphCache.h"
+#include "CharWidth.h"
+#include <QFontMetricsF>
+#include <QRawFont>
+#include <QTextLayout>
+#include <QVector>
+
+namespace {
+
+QString cacheKey(const QString& text, int style)
+{
+    QString key;
+    key.reserve(text.size() + 1);
+    key += QChar(static_cast<char16_t>(style));
+    key += text;
+    return key;
+}
+
+// Code point at text[i]; advances i past it
+char32_t nextCodePoint(const QString& text, int& i)
+{
+    const QChar ch = text.at(i++);
+    if (ch.isHighSurrogate() && i < text.size() && text.at(i).isLowSurrogate()) {
+        return QChar::surrogateToUcs4(ch, text.at(i++));
+    }
+    return ch.unicode();
+}
+
+// Joins shaped pieces into as few runs as possible: consecutive glyphs from the same
+// font share one QGlyphRun, so a row is usually a single draw call
+class RunBuilder {
+public:
+    explicit RunBuilder(bool underline) : m_underline(underline) {}
+
+    void add(const QList<QGlyphRun>& glyphs, qreal x)
+    {
+        for (const QGlyphRun& glyph : glyphs) {
+            if (glyph.rawFont() != m_font) {
+                flush();
+                m_font = glyph.rawFont();
+            }
+            m_indexes += glyph.glyphIndexes();
+            for (const QPointF& position : glyph.positions()) {
+                m_positions.append(QPointF(x + position.x(), position.y()));
+            }
+        }
+    }
+
+    QList<QGlyphRun> finish()
+    {
+        flush();
+        return m_runs;
+    }
+
+private:
+    void flush()
+    {
+        if (m_indexes.isEmpty()) {
+            return;
+        }
+        QGlyphRun run;
+        run.setRawFont(m_font);
+        run.setGlyphIndexes(m_indexes);
+        run.setPositions(m_positions);
+        run.setUnderline(m_underline);
+        m_runs.append(run);
+        m_indexes.clear();
+        m_positions.clear();
+    }
+
+    bool m_underline;
+    QRawFont m_font;
+    QVector<quint32> m_indexes;
+    QVector<QPointF> m_positions;
+    QList<QGlyphRun> m_runs;
+};
+
+} // namespace
+
+GlyphCache::GlyphCache()
+    : m_scale(1.0)
+    , m_cellWidth(0)
+    , m_ligatures(false)
+{
+    m_runs.setMaxCost(RunCapacity);
+    m_clusters.setMaxCost(ClusterCapacity);
+}
+
+void GlyphCache::setFont(const QFont& font, int cellWidth)
+{
+    m_font = font;
+    m_cellWidth = cellWidth;
+    const qreal advance = QFontMetricsF(font).horizontalAdvance(QLatin1Char('M'));
+    m_scale = advance > 0 ? cellWidth / advance : 1.0;
+    clear();
+}
+
+void GlyphCache::setLigaturesEnabled(bool enabled)
+{
+    if (enabled == m_ligatures) {
+        return;
+    }
+    // Clusters are shaped the same either way; only the runs are put together anew
+    m_ligatures = enabled;
+    m_runs.clear();
+}
+
+void GlyphCache::clear()
+{
+    m_runs.clear();
+    m_clusters.clear();
+}
+
+QList<QGlyphRun> GlyphCache::glyphs(const QString& text, int style)
+{
+    const QString key = cacheKey(text, style);
+    if (const QList<QGlyphRun>* cached = m_runs.object(key)) {
+        return *cached;
+    }
+
+    const QList<QGlyphRun> shaped = shapeRun(text, style);
+    m_runs.insert(key, new QList<QGlyphRun>(shaped));
+    return shaped;
+}
+
+QList<QGlyphRun> GlyphCache::shapeRun(const QString& text, int style)
+{
+    RunBuilder builder((style & Underline) != 0);
+    const int length = text.size();
+
+    // With ligatures on, consecutive single-column characters are laid out together
+    int segmentStart = -1;
+    int segmentColumn = 0;
+    auto flushSegment = [&](int end) {
+        if (segmentStart >= 0) {
+            builder.add(layoutText(text.mid(segmentStart, end - segmentStart), style),
+                        segmentColumn * m_cellWidth);
+            segmentStart = -1;
+        }
+    };
+
+    int column = 0;
+    int i = 0;
+    while (i < length) {
+        const int start = i;
+        const int width = Unicode::charWidth(nextCodePoint(text, i));
+        // Zero-width characters belong to the cluster before them
+        while (i < length) {
+            int next = i;
+            if (Unicode::charWidth(nextCodePoint(text, next)) != 0) {
+                break;
+            }
+            i = next;
+        }
+
+        const bool single = width == 1 && i - start == 1;
+        if (single && text.at(start) == QLatin1Char(' ')) {
+            flushSegment(start);
+        } else if (single && m_ligatures) {
+            if (segmentStart < 0) {
+                segmentStart = start;
+                segmentColumn = column;
+            }
+        } else {
+            flushSegment(start);
+            builder.add(shapeCluster(text.mid(start, i - start), style), column * m_cellWidth);
+        }
+        column += width;
+    }
+    flushSegment(length);
+
+    return builder.finish();
+}
+
+QList<QGlyphRun> GlyphCache::shapeCluster(const QString& text, int style)
+{
+    const QString key = cacheKey(text, style & (Bold | Italic));
+    if (const QList<QGlyphRun>* cached = m_clusters.object(key)) {
+        return *cached;
+    }
+
+    const QList<QGlyphRun> shaped = layoutText(text, style);
+    m_clusters.insert(key, new QList<QGlyphRun>(shaped));
+    return shaped;
+}
+
+QList<QGlyphRun> GlyphCache::layoutText(const QString& text, int style) const
+{
+    QTextLayout layout(text, fontFor(style));
+    QTextOption option;
+    option.setWrapMode(QTextOption::NoWrap);
+    option.setTextDirection(Qt::LeftToRight);
+    layout.setTextOption(option);
+    layout.beginLayout();
+    QTextLine line = layout.createLine();
+    layout.endLayout();
+
+    // Make positions relative to the baseline, since fallback fonts can give the line a
+    // different ascent, and fit the font's advances to the cell grid
+    const qreal baseline = line.ascent();
+    QList<QGlyphRun> runs = line.glyphRuns();
+    for (QGlyphRun& run : runs) {
+        QVector<QPointF> positions = run.positions();
+        for (QPointF& position : positions) {
+            position = QPointF(position.x() * m_scale, position.y() - baseline);
+        }
+        run.setPositions(positions);
+    }
+    return runs;
+}
+
+QFont GlyphCache::fontFor(int style) const
+{
+    QFont font = m_font;
+    font.setBold((style & Bold) != 0);
+    font.setItalic((style & Italic) != 0);
+    return font;
+}
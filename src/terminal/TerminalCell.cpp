@@ -0,0 +1,56 @@
+#include "TerminalCell.h"
+
+char32_t ClusterTable::intern(const QString& text)
+{
+    const auto found = m_ids.constFind(text);
+    if (found != m_ids.constEnd()) {
+        return found.value();
+    }
+
+    char32_t id;
+    if (!m_free.isEmpty()) {
+        id = m_free.takeLast();
+        m_texts[static_cast<int>(id - TerminalCell::ClusterBase)] = text;
+    } else if (m_texts.size() < Capacity) {
+        id = TerminalCell::ClusterBase + static_cast<char32_t>(m_texts.size());
+        m_texts.append(text);
+    } else {
+        return 0;
+    }
+    m_ids.insert(text, id);
+    return id;
+}
+
+void ClusterTable::mark(const TerminalCell* cells, int count)
+{
+    if (m_marked.size() != m_texts.size()) {
+        m_marked.fill(false, m_texts.size());
+    }
+    for (int i = 0; i < count; ++i) {
+        if (cells[i].isCluster()) {
+            const int index = static_cast<int>(cells[i].character - TerminalCell::ClusterBase);
+            if (index < m_marked.size()) {
+                m_marked[index] = true;
+            }
+        }
+    }
+}
+
+int ClusterTable::sweep()
+{
+    // Nothing marked means nothing is in use
+    m_marked.resize(m_texts.size());
+
+    int freed = 0;
+    for (int index = 0; index < m_texts.size(); ++index) {
+        if (m_marked[index] || m_texts[index].isNull()) {
+            continue;
+        }
+        m_ids.remove(m_texts[index]);
+        m_texts[index] = QString();
+        m_free.append(TerminalCell::ClusterBase + static_cast<char32_t>(index));
+        ++freed;
+    }
+    m_marked.clear();
+    return freed;
+}
@@ -1,4 +1,6 @@
 #include "TerminalScreen.h"
+#include "AllocTracker.h"
+#include "CharWidth.h"
 #include <algorithm>
 
 TerminalScreen::TerminalScreen(int rows, int cols)
@@ -8,8 +10,9 @@ TerminalScreen::TerminalScreen(int rows, int cols)
     , m_cursorCol(0)
     , m_cursorVisible(true)
     , m_useAlternate(false)
-    , m_currentFg(QColor(170, 170, 170))
-    , m_currentBg(QColor())
+    , m_scrollback(10000, cols)
+    , m_currentFg(TerminalColor::defaultForeground())
+    , m_currentBg(TerminalColor::defaultBackground())
     , m_currentBold(false)
     , m_currentUnderline(false)
     , m_currentInverse(false)
@@ -21,25 +24,195 @@ TerminalScreen::TerminalScreen(int rows, int cols)
     initBuffer(m_alternateBuffer);
 }
 
-void TerminalScreen::initBuffer(QVector<QVector<Cell>>& buffer)
+void TerminalScreen::initBuffer(QVector<Line>& buffer)
 {
     buffer.clear();
     buffer.resize(m_rows);
     for (int i = 0; i < m_rows; ++i) {
-        buffer[i].resize(m_cols);
+        buffer[i].cells.resize(m_cols);
     }
 }
 
+void TerminalScreen::clearRow(Line& line, int from, int to)
+{
+    if (to < 0 || to >= line.cells.size()) {
+        to = line.cells.size() - 1;
+    }
+    for (int col = std::max(0, from); col <= to; ++col) {
+        line.cells[col] = Cell();
+    }
+    line.wrapped = false;
+}
+
+void TerminalScreen::resizeBuffer(QVector<Line>& buffer, int rows, int cols, int firstRow)
+{
+    QVector<Line> resized(rows);
+    for (int row = 0; row < rows; ++row) {
+        int source = firstRow + row;
+        if (source < buffer.size()) {
+            resized[row] = buffer[source];
+        }
+        resized[row].cells.resize(cols);
+    }
+    buffer.swap(resized);
+}
+
+int TerminalScreen::lastContentRow(const QVector<Line>& buffer)
+{
+    for (int row = buffer.size() - 1; row >= 0; --row) {
+        const Line& line = buffer[row];
+        if (line.wrapped) {
+            return row;
+        }
+        for (const Cell& cell : line.cells) {
+            if (!cell.isBlank()) {
+                return row;
+            }
+        }
+    }
+    return 0;
+}
+
+void TerminalScreen::reflowBuffer(QVector<Line>& buffer, int rows, int cols, int& cursorRow,
+                                  int& cursorCol)
+{
+    // Rows below both the cursor and the last row with content carry nothing to keep
+    int lastRow = std::min(static_cast<int>(buffer.size()) - 1,
+                           std::max(cursorRow, lastContentRow(buffer)));
+
+    QVector<Line> reflowed;
+    reflowed.reserve(std::max(rows, lastRow + 1));
+    int newCursorRow = 0;
+    int newCursorCol = 0;
+
+    QVector<Cell> logical;
+    int cursorOffset = -1;
+
+    for (int row = 0; row <= lastRow; ++row) {
+        const Line& line = buffer[row];
+        if (row == cursorRow) {
+            cursorOffset = logical.size() + cursorCol;
+        }
+        // The padding left where a wide character wrapped early is not part of the text
+        logical += line.cells.mid(0, line.joinedLength());
+
+        if (line.wrapped && row < lastRow) {
+            continue;
+        }
+
+        // Join complete: trim padding and re-wrap at the new width
+        int length = logical.size();
+        while (length > 0 && logical[length - 1].isBlank()) {
+            --length;
+        }
+        logical.resize(length);
+
+        // Row starts at the new width; a wide character never straddles two rows
+        QVector<int> starts;
+        int start = 0;
+        do {
+            starts.append(start);
+            start += Line::rowLength(logical.constData() + start, length - start, cols);
+        } while (start < length);
+
+        int lineRows = starts.size();
+        if (cursorOffset >= 0) {
+            const int lastStart = starts.last();
+            int cursorLineRow;
+            if (cursorOffset > 0 && cursorOffset == length && length - lastStart == cols) {
+                // Cursor sits in the pending-wrap position after a full row
+                cursorLineRow = lineRows - 1;
+                newCursorCol = cols;
+            } else if (cursorOffset >= lastStart) {
+                cursorLineRow = lineRows - 1 + (cursorOffset - lastStart) / cols;
+                newCursorCol = (cursorOffset - lastStart) % cols;
+            } else {
+                const auto next = std::upper_bound(starts.cbegin(), starts.cend(), cursorOffset);
+                cursorLineRow = static_cast<int>(next - starts.cbegin()) - 1;
+                newCursorCol = cursorOffset - starts[cursorLineRow];
+            }
+            lineRows = std::max(lineRows, cursorLineRow + 1);
+            newCursorRow = reflowed.size() + cursorLineRow;
+            cursorOffset = -1;
+        }
+
+        for (int i = 0; i < lineRows; ++i) {
+            Line out;
+            if (i < starts.size()) {
+                const int end = i + 1 < starts.size() ? starts[i + 1] : length;
+                out.cells = logical.mid(starts[i], end - starts[i]);
+                out.wrapped = i + 1 < starts.size();
+                if (out.wrapped && out.cells.size() < cols) {
+                    // A wide character moved to the next row; pad the column it left
+                    Cell padding;
+                    padding.width = 0;
+                    out.cells.append(padding);
+                }
+            }
+            out.cells.resize(cols);
+            reflowed.append(out);
+        }
+
+        logical.clear();
+    }
+
+    // Push rows that no longer fit into scrollback, but never scroll the cursor off
+    int excess = reflowed.size() - rows;
+    if (excess > 0) {
+        int fromTop = std::min(excess, newCursorRow);
+        if (&buffer == &m_normalBuffer) {
+            for (int i = 0; i < fromTop; ++i) {
+                m_scrollback.pushRow(reflowed[i]);
+            }
+        }
+        reflowed.remove(0, fromTop);
+        newCursorRow -= fromTop;
+    }
+
+    reflowed.resize(rows);
+    for (Line& line : reflowed) {
+        line.cells.resize(cols);
+    }
+
+    buffer.swap(reflowed);
+    cursorRow = newCursorRow;
+    cursorCol = newCursorCol;
+}
+
 void TerminalScreen::resize(int rows, int cols)
 {
+    ALLOC_SCOPE(Screen);
+    if (rows <= 0 || cols <= 0 || (rows == m_rows && cols == m_cols)) {
+        return;
+    }
+
+    // Soft-wrapped lines on the normal screen are rewrapped to the new width and rows
+    // that no longer fit go to scrollback, whose own reflow is deferred until viewed.
+    // The alternate screen belongs to full-screen programs that redraw on SIGWINCH,
+    // so it is only cropped or padded.
+    m_scrollback.closeLine();
+    m_scrollback.setWidth(cols);
+
+    if (m_useAlternate) {
+        int shift = std::max(0, m_cursorRow - (rows - 1));
+        resizeBuffer(m_alternateBuffer, rows, cols, shift);
+        m_cursorRow -= shift;
+
+        int normalRow = lastContentRow(m_normalBuffer);
+        int normalCol = 0;
+        reflowBuffer(m_normalBuffer, rows, cols, normalRow, normalCol);
+    } else {
+        reflowBuffer(m_normalBuffer, rows, cols, m_cursorRow, m_cursorCol);
+        resizeBuffer(m_alternateBuffer, rows, cols, 0);
+    }
+
     m_rows = rows;
     m_cols = cols;
-    m_scrollBottom = rows - 1;
+    resetScrollRegion();
 
-    initBuffer(m_normalBuffer);
-    initBuffer(m_alternateBuffer);
-
-    ensureCursorInBounds();
+    // Keep the pending-wrap column that putChar() relies on
+    m_cursorRow = std::clamp(m_cursorRow, 0, m_rows - 1);
+    m_cursorCol = std::clamp(m_cursorCol, 0, m_cols);
 }
 
 void TerminalScreen::setCursorPos(int row, int col)
@@ -56,7 +229,7 @@ TerminalScreen::Cell& TerminalScreen::cellAt(int row, int col)
     }
 
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
-    return buffer[row][col];
+    return buffer[row].cells[col];
 }
 
 const TerminalScreen::Cell& TerminalScreen::cellAt(int row, int col) const
@@ -67,37 +240,200 @@ const TerminalScreen::Cell& TerminalScreen::cellAt(int row, int col) const
     }
 
     const auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
-    return buffer[row][col];
+    return buffer[row].cells[col];
+}
+
+const TerminalScreen::Line& TerminalScreen::line(int row) const
+{
+    static const Line empty;
+    if (row < 0 || row >= m_rows) {
+        return empty;
+    }
+
+    const auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
+    return buffer[row];
 }
 
 void TerminalScreen::putChar(QChar ch)
+{
+    putText(&ch, 1);
+}
+
+void TerminalScreen::putChar(QChar ch, int row, int col)
+{
+    setCursorPos(row, col);
+    putChar(ch);
+}
+
+TerminalScreen::Cell TerminalScreen::styledCell() const
+{
+    Cell styled;
+    styled.fgColor = m_currentInverse ? m_currentBg : m_currentFg;
+    styled.bgColor = m_currentInverse ? m_currentFg : m_currentBg;
+    styled.bold = m_currentBold;
+    styled.underline = m_currentUnderline;
+    styled.inverse = m_currentInverse;
+    styled.italic = m_currentItalic;
+    return styled;
+}
+
+TerminalScreen::Cell* TerminalScreen::cursorRowCells()
 {
     if (m_cursorRow >= m_rows) {
         scrollUp();
         m_cursorRow = m_rows - 1;
     }
 
+    auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
     if (m_cursorCol >= m_cols) {
+        // Deferred autowrap: the row continues on the next one
+        buffer[m_cursorRow].wrapped = true;
         newLine();
+    }
+    return buffer[m_cursorRow].cells.data();
+}
+
+void TerminalScreen::breakWide(Cell* cells, int from, int to) const
+{
+    // Overwriting one half of a wide character leaves the other half blank
+    if (cells[from].width == 0 && from > 0 && cells[from - 1].width == 2) {
+        cells[from - 1].character = ' ';
+        cells[from - 1].width = 1;
+    }
+    if (to < m_cols && cells[to].width == 0 && cells[to - 1].width == 2) {
+        cells[to].character = ' ';
+        cells[to].width = 1;
+    }
+}
+
+void TerminalScreen::putText(const QChar* text, int length)
+{
+    ALLOC_SCOPE(Screen);
+    const Cell styled = styledCell();
+
+    int i = 0;
+    while (i < length) {
+        const char16_t ch = text[i].unicode();
+        if (ch < 0x20) {
+            // C0 controls have no glyph; the emulator executes them before they get here
+            ++i;
+            continue;
+        }
+        if (ch >= 0x7f) {
+            char32_t cp = ch;
+            if (text[i].isHighSurrogate() && i + 1 < length && text[i + 1].isLowSurrogate()) {
+                cp = QChar::surrogateToUcs4(text[i], text[i + 1]);
+                ++i;
+            }
+            ++i;
+            putCodePoint(cp, styled);
+            continue;
+        }
+
+        // Printable ASCII fills the rest of the row without per-character width or bounds
+        // checks
+        Cell* cells = cursorRowCells();
+        const int limit = i + std::min(length - i, m_cols - m_cursorCol);
+        int end = i + 1;
+        while (end < limit && text[end].unicode() >= 0x20 && text[end].unicode() < 0x7f) {
+            ++end;
+        }
+
+        breakWide(cells, m_cursorCol, m_cursorCol + (end - i));
+        for (; i < end; ++i) {
+            Cell& cell = cells[m_cursorCol++];
+            cell = styled;
+            cell.character = text[i].unicode();
+        }
+    }
+}
+
+void TerminalScreen::putCodePoint(char32_t cp, const Cell& styled)
+{
+    // DEL, C1 controls and unpaired surrogates have no glyph
+    if (cp < 0xa0 || (cp >= 0xd800 && cp <= 0xdfff)) {
+        return;
+    }
+
+    const int width = std::min(Unicode::charWidth(cp), m_cols);
+    if (width == 0) {
+        combine(cp);
         return;
     }
 
-    Cell& cell = cellAt(m_cursorRow, m_cursorCol);
-    cell.character = ch;
-    cell.fgColor = m_currentInverse ? m_currentBg : m_currentFg;
-    cell.bgColor = m_currentInverse ? m_currentFg : m_currentBg;
-    cell.bold = m_currentBold;
-    cell.underline = m_currentUnderline;
-    cell.inverse = m_currentInverse;
-    cell.italic = m_currentItalic;
+    Cell* cells = cursorRowCells();
+    if (m_cursorCol + width > m_cols) {
+        // A wide character never straddles rows: pad the last column and wrap
+        breakWide(cells, m_cursorCol, m_cursorCol + 1);
+        Cell& padding = cells[m_cursorCol];
+        padding = styled;
+        padding.width = 0;
+        m_cursorCol = m_cols;
+        cells = cursorRowCells();
+    }
 
-    m_cursorCol++;
+    const int col = m_cursorCol;
+    breakWide(cells, col, col + width);
+    cells[col] = styled;
+    cells[col].character = cp;
+    cells[col].width = width;
+    if (width == 2) {
+        cells[col + 1] = styled;
+        cells[col + 1].width = 0;
+    }
+    m_cursorCol += width;
 }
 
-void TerminalScreen::putChar(QChar ch, int row, int col)
+void TerminalScreen::combine(char32_t mark)
 {
-    setCursorPos(row, col);
-    putChar(ch);
+    // A mark attaches to the character before the cursor; with none on this row
+    // it is dropped
+    if (m_cursorRow >= m_rows || m_cursorCol == 0) {
+        return;
+    }
+
+    auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
+    Cell* cells = buffer[m_cursorRow].cells.data();
+    int col = std::min(m_cursorCol, m_cols) - 1;
+    if (cells[col].width == 0) {
+        if (col == 0 || cells[col - 1].width != 2) {
+            return;
+        }
+        --col;
+    }
+
+    QString cluster;
+    cells[col].appendText(cluster, m_clusters);
+    if (QChar::requiresSurrogates(mark)) {
+        cluster += QChar(QChar::highSurrogate(mark));
+        cluster += QChar(QChar::lowSurrogate(mark));
+    } else {
+        cluster += QChar(static_cast<char16_t>(mark));
+    }
+
+    char32_t id = m_clusters.intern(cluster);
+    if (id == 0) {
+        reclaimClusters();
+        id = m_clusters.intern(cluster);
+    }
+    if (id != 0) {
+        cells[col].character = id;
+    }
+}
+
+void TerminalScreen::reclaimClusters()
+{
+    // Ids held by neither buffer nor the scrollback can be handed out again
+    for (const Line& line : m_normalBuffer) {
+        m_clusters.mark(line.cells.constData(), line.cells.size());
+    }
+    for (const Line& line : m_alternateBuffer) {
+        m_clusters.mark(line.cells.constData(), line.cells.size());
+    }
+    for (const TerminalScrollback::RowView& view : m_scrollback) {
+        m_clusters.mark(view.cells, view.length);
+    }
+    m_clusters.sweep();
 }
 
 void TerminalScreen::newLine()
@@ -118,6 +454,9 @@ void TerminalScreen::carriageReturn()
 
 void TerminalScreen::backspace()
 {
+    if (m_cursorCol >= m_cols) {
+        m_cursorCol = m_cols - 1;
+    }
     if (m_cursorCol > 0) {
         m_cursorCol--;
     }
@@ -136,9 +475,7 @@ void TerminalScreen::clearScreen()
 {
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
     for (int row = 0; row < m_rows; ++row) {
-        for (int col = 0; col < m_cols; ++col) {
-            buffer[row][col] = Cell();
-        }
+        clearRow(buffer[row]);
     }
 }
 
@@ -147,15 +484,11 @@ void TerminalScreen::clearFromCursorToEnd()
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
 
     // Clear from cursor to end of line
-    for (int col = m_cursorCol; col < m_cols; ++col) {
-        buffer[m_cursorRow][col] = Cell();
-    }
+    clearRow(buffer[m_cursorRow], m_cursorCol);
 
     // Clear all lines below
     for (int row = m_cursorRow + 1; row < m_rows; ++row) {
-        for (int col = 0; col < m_cols; ++col) {
-            buffer[row][col] = Cell();
-        }
+        clearRow(buffer[row]);
     }
 }
 
@@ -164,73 +497,72 @@ void TerminalScreen::clearFromCursorToBeginning()
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
 
     // Clear from beginning of line to cursor
-    for (int col = 0; col <= m_cursorCol; ++col) {
-        buffer[m_cursorRow][col] = Cell();
-    }
+    Line& cursorLine = buffer[m_cursorRow];
+    bool wrapped = cursorLine.wrapped;
+    clearRow(cursorLine, 0, m_cursorCol);
+    cursorLine.wrapped = wrapped;
 
     // Clear all lines above
     for (int row = 0; row < m_cursorRow; ++row) {
-        for (int col = 0; col < m_cols; ++col) {
-            buffer[row][col] = Cell();
-        }
+        clearRow(buffer[row]);
     }
 }
 
 void TerminalScreen::clearLine()
 {
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
-    for (int col = 0; col < m_cols; ++col) {
-        buffer[m_cursorRow][col] = Cell();
-    }
+    clearRow(buffer[m_cursorRow]);
 }
 
 void TerminalScreen::clearLineFromCursor()
 {
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
-    for (int col = m_cursorCol; col < m_cols; ++col) {
-        buffer[m_cursorRow][col] = Cell();
-    }
+    clearRow(buffer[m_cursorRow], m_cursorCol);
 }
 
 void TerminalScreen::clearLineToCursor()
 {
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
-    for (int col = 0; col <= m_cursorCol; ++col) {
-        buffer[m_cursorRow][col] = Cell();
-    }
+    Line& line = buffer[m_cursorRow];
+    bool wrapped = line.wrapped;
+    clearRow(line, 0, m_cursorCol);
+    line.wrapped = wrapped;
 }
 
 void TerminalScreen::scrollUp(int lines)
 {
+    ALLOC_SCOPE(Screen);
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
+    lines = std::min(lines, m_scrollBottom - m_scrollTop + 1);
 
     for (int i = 0; i < lines; ++i) {
-        // Move lines up within scroll region
-        for (int row = m_scrollTop; row < m_scrollBottom; ++row) {
-            buffer[row] = buffer[row + 1];
+        // Lines leaving the top of the full normal screen go to scrollback
+        if (!m_useAlternate && m_scrollTop == 0) {
+            m_scrollback.pushRow(buffer[m_scrollTop]);
         }
 
+        // Move lines up within scroll region, recycling the top row as the new bottom
+        std::rotate(buffer.begin() + m_scrollTop, buffer.begin() + m_scrollTop + 1,
+                    buffer.begin() + m_scrollBottom + 1);
+
         // Clear bottom line
-        for (int col = 0; col < m_cols; ++col) {
-            buffer[m_scrollBottom][col] = Cell();
-        }
+        clearRow(buffer[m_scrollBottom]);
     }
 }
 
 void TerminalScreen::scrollDown(int lines)
 {
+    ALLOC_SCOPE(Screen);
     auto& buffer = m_useAlternate ? m_alternateBuffer : m_normalBuffer;
+    lines = std::min(lines, m_scrollBottom - m_scrollTop + 1);
 
     for (int i = 0; i < lines; ++i) {
-        // Move lines down within scroll region
-        for (int row = m_scrollBottom; row > m_scrollTop; --row) {
-            buffer[row] = buffer[row - 1];
-        }
+        // Move lines down within scroll region, recycling the bottom row as the new top
+        std::rotate(buffer.begin() + m_scrollTop, buffer.begin() + m_scrollBottom,
+                    buffer.begin() + m_scrollBottom + 1);
 
         // Clear top line
-        for (int col = 0; col < m_cols; ++col) {
-            buffer[m_scrollTop][col] = Cell();
-        }
+        clearRow(buffer[m_scrollTop]);
     }
 }
 
@@ -248,8 +580,8 @@ void TerminalScreen::useNormalBuffer()
 
 void TerminalScreen::resetAttributes()
 {
-    m_currentFg = QColor(170, 170, 170);
-    m_currentBg = QColor();
+    m_currentFg = TerminalColor::defaultForeground();
+    m_currentBg = TerminalColor::defaultBackground();
     m_currentBold = false;
     m_currentUnderline = false;
     m_currentInverse = false;
@@ -271,9 +603,3 @@ void TerminalScreen::resetScrollRegion()
     m_scrollTop = 0;
     m_scrollBottom = m_rows - 1;
 }
-
-void TerminalScreen::ensureCursorInBounds()
-{
-    m_cursorRow = std::clamp(m_cursorRow, 0, m_rows - 1);
-    m_cursorCol = std::clamp(m_cursorCol, 0, m_cols - 1);
-}
@@ -0,0 +1,337 @@
+#include "TerminalScrollback.h"
+#include "AllocTracker.h"
+#include <algorithm>
+
+TerminalScrollback::TerminalScrollback(int maxLines, int width)
+    : m_width(std::max(1, width)), m_maxLines(maxLines), m_lineCount(0), m_cellCount(0),
+      m_lastOpen(false), m_laidOut(0), m_bottom(0)
+{
+}
+
+void TerminalScrollback::setWidth(int width)
+{
+    // Pages are laid out again as they are next accessed
+    width = std::max(1, width);
+    if (width != m_width) {
+        m_width = width;
+        m_laidOut = 0;
+    }
+}
+
+void TerminalScrollback::setMaxLines(int lines)
+{
+    m_maxLines = std::max(0, lines);
+    enforceLineLimit();
+}
+
+void TerminalScrollback::pushRow(const TerminalLine& row)
+{
+    ALLOC_SCOPE(Scrollback);
+    if (m_maxLines <= 0) {
+        return;
+    }
+
+    if (m_lastOpen && !m_pages.empty()) {
+        // Continuation of a soft-wrapped line
+        Page& page = m_pages.back();
+        const int oldRows = rowsForLine(page.lines.last(), m_width);
+        m_cellCount -= page.lines.last().size();
+        page.lines.last() += row.cells;
+        finishRow(page.lines.last(), row);
+        m_cellCount += page.lines.last().size();
+        growNewestPage(rowsForLine(page.lines.last(), m_width) - oldRows);
+    } else {
+        if (m_pages.empty() || m_pages.back().lines.size() >= PageSize) {
+            const bool laidOut = m_laidOut > 0;
+            m_pages.emplace_back();
+            m_pages.back().lines.reserve(PageSize);
+            if (laidOut) {
+                // An empty page sitting just below the previous newest one
+                m_pages.back().bottom = m_bottom;
+                ++m_laidOut;
+            }
+        }
+
+        Page& page = m_pages.back();
+        page.lines.append(row.cells);
+        finishRow(page.lines.last(), row);
+        m_cellCount += page.lines.last().size();
+        if (m_laidOut > 0) {
+            page.rowStarts.append(page.rowCount);
+        }
+        growNewestPage(rowsForLine(page.lines.last(), m_width));
+        ++m_lineCount;
+    }
+
+    m_lastOpen = row.wrapped;
+    enforceLineLimit();
+}
+
+void TerminalScrollback::clear()
+{
+    m_pages.clear();
+    m_lineCount = 0;
+    m_cellCount = 0;
+    m_lastOpen = false;
+    m_laidOut = 0;
+    m_bottom = 0;
+}
+
+TerminalScrollback::RowView TerminalScrollback::rowFromBottom(int index) const
+{
+    RowView view;
+    layoutNewest(1);
+    if (index < 0 || m_laidOut == 0) {
+        return view;
+    }
+
+    // Lay out older pages until one reaches the row
+    const qint64 target = m_bottom + index;
+    while (m_laidOut < static_cast<int>(m_pages.size())) {
+        const Page& oldest = newestPage(m_laidOut - 1);
+        if (target < oldest.bottom + oldest.rowCount) {
+            break;
+        }
+        layoutNewest(m_laidOut + 1);
+    }
+
+    // Laid-out pages have decreasing bottoms from oldest to newest
+    auto first = m_pages.cbegin() + (m_pages.size() - m_laidOut);
+    auto found = std::partition_point(first, m_pages.cend(),
+                                      [target](const Page& page) { return page.bottom > target; });
+    if (found == m_pages.cend() || target >= found->bottom + found->rowCount) {
+        return view;
+    }
+
+    const Page& page = *found;
+    int rowInPage = page.rowCount - 1 - static_cast<int>(target - page.bottom);
+    auto pos = std::upper_bound(page.rowStarts.cbegin(), page.rowStarts.cend(), rowInPage);
+    int lineIndex = static_cast<int>(pos - page.rowStarts.cbegin()) - 1;
+    int rowInLine = rowInPage - page.rowStarts[lineIndex];
+
+    const QVector<TerminalCell>& cells = page.lines[lineIndex];
+    int start = 0;
+    for (int row = 0; row < rowInLine; ++row) {
+        start = rowEnd(cells, start, m_width);
+    }
+    const int end = rowEnd(cells, start, m_width);
+    view.cells = cells.constData() + start;
+    view.length = end - start;
+    view.wrapped = end < cells.size();
+    view.valid = true;
+    return view;
+}
+
+int TerminalScrollback::rowCount() const
+{
+    if (m_pages.empty()) {
+        return 0;
+    }
+    layoutNewest(static_cast<int>(m_pages.size()));
+    const Page& oldest = m_pages.front();
+    return static_cast<int>(oldest.bottom + oldest.rowCount - m_bottom);
+}
+
+int TerminalScrollback::findFromBottom(const QString& text, const ClusterTable& clusters,
+                                       int startRow, Qt::CaseSensitivity cs) const
+{
+    if (text.isEmpty()) {
+        return -1;
+    }
+
+    for (int p = 0; p < static_cast<int>(m_pages.size()); ++p) {
+        layoutNewest(p + 1);
+        const Page* page = &newestPage(p);
+        int rowsBelow = static_cast<int>(page->bottom - m_bottom);
+
+        // Skip whole pages that lie below the starting row
+        if (rowsBelow + page->rowCount <= startRow) {
+            continue;
+        }
+
+        for (int i = page->lines.size() - 1; i >= 0; --i) {
+            const QVector<TerminalCell>& cells = page->lines[i];
+            int lineRows = rowsForLine(cells, m_width);
+
+            if (rowsBelow + lineRows > startRow) {
+                // Surrogate pairs and clusters make the text longer than the cells,
+                // so remember the column each character came from
+                QString lineText;
+                QVector<int> columns;
+                lineText.reserve(cells.size());
+                columns.reserve(cells.size());
+                for (int col = 0; col < cells.size(); ++col) {
+                    cells[col].appendText(lineText, clusters);
+                    while (columns.size() < lineText.size()) {
+                        columns.append(col);
+                    }
+                }
+
+                QVector<int> rowStarts;
+                for (int start = 0; rowStarts.size() < lineRows;
+                     start = rowEnd(cells, start, m_width)) {
+                    rowStarts.append(start);
+                }
+
+                // Latest match whose starting row is at or above startRow
+                int from = -1;
+                while (true) {
+                    int pos = lineText.lastIndexOf(text, from, cs);
+                    if (pos < 0) {
+                        break;
+                    }
+                    auto next = std::upper_bound(rowStarts.cbegin(), rowStarts.cend(),
+                                                 columns[pos]);
+                    int rowInLine = static_cast<int>(next - rowStarts.cbegin()) - 1;
+                    int row = rowsBelow + (lineRows - 1 - rowInLine);
+                    if (row >= startRow) {
+                        return row;
+                    }
+                    if (pos == 0) {
+                        break;
+                    }
+                    from = pos - 1;
+                }
+            }
+
+            rowsBelow += lineRows;
+        }
+    }
+
+    return -1;
+}
+
+TerminalScrollback::RowView TerminalScrollback::const_iterator::operator*() const
+{
+    const QVector<TerminalCell>& line = cells();
+    const int end = rowEnd(line, m_start, m_scrollback->m_width);
+    RowView view;
+    view.cells = line.constData() + m_start;
+    view.length = end - m_start;
+    view.wrapped = end < line.size();
+    view.valid = true;
+    return view;
+}
+
+TerminalScrollback::const_iterator& TerminalScrollback::const_iterator::operator++()
+{
+    m_start = rowEnd(cells(), m_start, m_scrollback->m_width);
+    if (m_start < cells().size()) {
+        return *this;
+    }
+
+    m_start = 0;
+    if (++m_line == m_scrollback->m_pages[m_page].lines.size()) {
+        m_line = 0;
+        ++m_page;
+    }
+    return *this;
+}
+
+const QVector<TerminalCell>& TerminalScrollback::const_iterator::cells() const
+{
+    return m_scrollback->m_pages[m_page].lines[m_line];
+}
+
+void TerminalScrollback::Page::layout(int width) const
+{
+    rowStarts.resize(lines.size());
+    int rows = 0;
+    for (int i = 0; i < lines.size(); ++i) {
+        rowStarts[i] = rows;
+        rows += rowsForLine(lines[i], width);
+    }
+
+    rowCount = rows;
+}
+
+void TerminalScrollback::layoutNewest(int count) const
+{
+    count = std::min(count, static_cast<int>(m_pages.size()));
+    while (m_laidOut < count) {
+        const Page& page = newestPage(m_laidOut);
+        page.layout(m_width);
+        if (m_laidOut == 0) {
+            m_bottom = 0;
+            page.bottom = 0;
+        } else {
+            const Page& newer = newestPage(m_laidOut - 1);
+            page.bottom = newer.bottom + newer.rowCount;
+        }
+        ++m_laidOut;
+    }
+}
+
+void TerminalScrollback::growNewestPage(int rows)
+{
+    if (m_laidOut == 0) {
+        return;
+    }
+    // The page's top stays where it is and everything below moves down
+    Page& page = m_pages.back();
+    page.rowCount += rows;
+    m_bottom -= rows;
+    page.bottom = m_bottom;
+}
+
+int TerminalScrollback::rowEnd(const QVector<TerminalCell>& cells, int start, int width)
+{
+    return start + TerminalLine::rowLength(cells.constData() + start, cells.size() - start, width);
+}
+
+int TerminalScrollback::rowsForLine(const QVector<TerminalCell>& cells, int width)
+{
+    int rows = 1;
+    for (int start = rowEnd(cells, 0, width); start < cells.size();
+         start = rowEnd(cells, start, width)) {
+        ++rows;
+    }
+    return rows;
+}
+
+void TerminalScrollback::finishRow(QVector<TerminalCell>& cells, const TerminalLine& row)
+{
+    if (row.wrapped) {
+        // Padding where a wide character wrapped early; the line is re-wrapped on layout
+        if (row.joinedLength() < row.cells.size()) {
+            cells.removeLast();
+        }
+        return;
+    }
+    int length = cells.size();
+    while (length > 0 && cells[length - 1].isBlank()) {
+        --length;
+    }
+    cells.resize(length);
+}
+
+void TerminalScrollback::enforceLineLimit()
+{
+    while (m_lineCount > m_maxLines && !m_pages.empty()) {
+        Page& front = m_pages.front();
+        const bool laidOut = m_laidOut == static_cast<int>(m_pages.size());
+        if (laidOut) {
+            // The oldest line leaves from the page's top, so its bottom stays put
+            const int rows = rowsForLine(front.lines.first(), m_width);
+            front.rowStarts.removeFirst();
+            for (int& rowStart : front.rowStarts) {
+                rowStart -= rows;
+            }
+            front.rowCount -= rows;
+        }
+        m_cellCount -= front.lines.first().size();
+        front.lines.removeFirst();
+        --m_lineCount;
+
+        if (front.lines.isEmpty()) {
+            m_pages.pop_front();
+            if (laidOut) {
+                --m_laidOut;
+            }
+        }
+    }
+
+    if (m_pages.empty()) {
+        m_lastOpen = false;
+    }
+}
@@ -1,25 +1,58 @@
 #include "TerminalView.h"
+#include "AllocTracker.h"
+#include "LatencyTracker.h"
+#include "Metrics.h"
+#include "Tracer.h"
 #include <QPainter>
 #include <QKeyEvent>
 #include <QMouseEvent>
+#include <QWheelEvent>
 #include <QResizeEvent>
 #include <QFocusEvent>
 #include <QApplication>
 #include <QClipboard>
+#include <QElapsedTimer>
+#include <QGlyphRun>
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+
+int glyphStyle(const TerminalCell& cell)
+{
+    return (cell.bold ? GlyphCache::Bold : 0) | (cell.italic ? GlyphCache::Italic : 0) |
+           (cell.underline ? GlyphCache::Underline : 0);
+}
+
+} // namespace
 
 TerminalView::TerminalView(QWidget* parent)
     : QWidget(parent)
     , m_emulator(24, 80)
     , m_charWidth(0)
     , m_charHeight(0)
+    , m_charAscent(0)
     , m_rows(24)
     , m_columns(80)
+    , m_scrollOffset(0)
     , m_cursorVisible(true)
     , m_hasFocus(false)
+    , m_latencyTracker(nullptr)
+    , m_latencyOverlayVisible(false)
+    , m_metrics(nullptr)
+    , m_metricsOverlayVisible(false)
+    , m_framePending(false)
+    , m_theme(ColorTheme::defaultTheme())
 {
     setupTerminal();
     setupFont();
     calculateMetrics();
+    setMinimumSize(MinimumColumns * m_charWidth, MinimumRows * m_charHeight);
+
+    m_resizeTimer = new QTimer(this);
+    m_resizeTimer->setSingleShot(true);
+    m_resizeTimer->setInterval(ResizeSettleDelay);
+    connect(m_resizeTimer, &QTimer::timeout, this, &TerminalView::emitSettledSize);
 
     m_cursorTimer = new QTimer(this);
     connect(m_cursorTimer, &QTimer::timeout, this, &TerminalView::blinkCursor);
@@ -38,11 +71,25 @@ void TerminalView::setupTerminal()
 {
     // Set background color
     QPalette p = palette();
-    p.setColor(QPalette::Window, QColor(0, 0, 0));
+    p.setColor(QPalette::Window, QColor::fromRgb(m_theme.background));
     setPalette(p);
     setAutoFillBackground(true);
 }
 
+void TerminalView::setTheme(const ColorTheme& theme)
+{
+    // Cells hold palette indices, so this is all a theme switch takes
+    m_theme = theme;
+    setupTerminal();
+    update();
+}
+
+void TerminalView::setLigaturesEnabled(bool enabled)
+{
+    m_glyphs.setLigaturesEnabled(enabled);
+    update();
+}
+
 void TerminalView::setupFont()
 {
 #ifdef Q_OS_MAC
@@ -62,34 +109,108 @@ void TerminalView::calculateMetrics()
     QFontMetrics fm(m_font);
     m_charWidth = fm.horizontalAdvance('M');
     m_charHeight = fm.height();
+    m_charAscent = fm.ascent();
+    m_glyphs.setFont(m_font, m_charWidth);
+}
 
-    int minWidth = m_charWidth * m_columns;
-    int minHeight = m_charHeight * m_rows;
-    setMinimumSize(minWidth, minHeight);
+QSize TerminalView::sizeHint() const
+{
+    return QSize(80 * m_charWidth, 24 * m_charHeight);
 }
 
 void TerminalView::displayOutput(const QString& text)
 {
+    TRACE_SPAN(ScreenUpdate);
+    ALLOC_SCOPE(Ui);
+    QElapsedTimer timer;
+    timer.start();
     m_emulator.processData(text);
+    recordOutputApplied(timer.nsecsElapsed());
     update();
 }
 
 void TerminalView::displayOutput(const QByteArray& data)
 {
+    TRACE_SPAN(ScreenUpdate);
+    ALLOC_SCOPE(Ui);
+    QElapsedTimer timer;
+    timer.start();
     m_emulator.processData(data);
+    recordOutputApplied(timer.nsecsElapsed());
     update();
 }
 
+void TerminalView::recordOutputApplied(qint64 parseNs)
+{
+    if (m_latencyTracker) {
+        m_latencyTracker->markApplied();
+    }
+
+    if (m_metrics) {
+        m_metrics->parseTimeNs.record(static_cast<quint64>(parseNs));
+        m_metrics->scrollbackBytes.set(m_emulator.screen().scrollback().memoryUsage());
+
+        // Output arriving before the previous chunk was painted is folded into one frame
+        if (m_framePending) {
+            m_metrics->framesSkipped.add();
+        }
+    }
+    m_framePending = true;
+}
+
+void TerminalView::setLatencyTracker(LatencyTracker* tracker)
+{
+    m_latencyTracker = tracker;
+    if (m_latencyOverlayVisible) {
+        update();
+    }
+}
+
+void TerminalView::setLatencyOverlayVisible(bool visible)
+{
+    if (visible != m_latencyOverlayVisible) {
+        m_latencyOverlayVisible = visible;
+        update();
+    }
+}
+
+void TerminalView::setMetrics(SessionMetrics* metrics)
+{
+    m_metrics = metrics;
+    if (m_metricsOverlayVisible) {
+        update();
+    }
+}
+
+void TerminalView::setMetricsOverlayVisible(bool visible)
+{
+    if (visible != m_metricsOverlayVisible) {
+        m_metricsOverlayVisible = visible;
+        update();
+    }
+}
+
 void TerminalView::setDimensions(int rows, int columns)
 {
+    if (rows <= 0 || columns <= 0 || (rows == m_rows && columns == m_columns)) {
+        return;
+    }
+
+    // Resize locally right away so the view follows the drag; the remote side is
+    // only told once the size settles
     m_rows = rows;
     m_columns = columns;
     m_emulator.resize(rows, columns);
-    calculateMetrics();
     emit dimensionsChanged(rows, columns);
+    m_resizeTimer->start();
     update();
 }
 
+void TerminalView::emitSettledSize()
+{
+    emit terminalSizeSettled(m_rows, m_columns);
+}
+
 int TerminalView::rows() const
 {
     return m_rows;
@@ -106,62 +227,272 @@ void TerminalView::clearDisplay()
     update();
 }
 
+void TerminalView::scrollViewBy(int rows)
+{
+    const TerminalScreen& screen = m_emulator.screen();
+    int offset = screen.isAlternateBuffer() ? 0 : std::max(0, m_scrollOffset + rows);
+
+    // Validate against the rows just above the target so that only the history
+    // pages being shown get laid out at the current width
+    if (offset > 0 && !screen.scrollback().rowFromBottom(offset - 1).valid) {
+        offset = screen.scrollback().rowCount();
+    }
+
+    if (offset != m_scrollOffset) {
+        m_scrollOffset = offset;
+        update();
+    }
+}
+
+void TerminalView::scrollToBottom()
+{
+    if (m_scrollOffset != 0) {
+        m_scrollOffset = 0;
+        update();
+    }
+}
+
 void TerminalView::paintEvent(QPaintEvent*)
 {
+    TRACE_SPAN(Paint);
+    ALLOC_SCOPE(Ui);
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+
     QPainter painter(this);
-    painter.setFont(m_font);
 
     const TerminalScreen& screen = m_emulator.screen();
+    const TerminalScrollback& history = screen.scrollback();
+    const TerminalScreen::Cell blank;
+    int scrollOffset = screen.isAlternateBuffer() ? 0 : m_scrollOffset;
+    QString text;
 
     // Draw all cells
     for (int row = 0; row < m_rows; ++row) {
-        for (int col = 0; col < m_columns; ++col) {
-            const TerminalScreen::Cell& cell = screen.cellAt(row, col);
-            QRect cellRect = getCellRect(row, col);
+        // Rows above the live screen come from scrollback when scrolled back
+        const TerminalScreen::Cell* cells = nullptr;
+        int cellCount = 0;
+        int screenRow = row - scrollOffset;
+        if (screenRow >= 0) {
+            const TerminalScreen::Line& line = screen.line(screenRow);
+            cells = line.cells.constData();
+            cellCount = line.cells.size();
+        } else {
+            TerminalScrollback::RowView view = history.rowFromBottom(-screenRow - 1);
+            cells = view.cells;
+            cellCount = view.length;
+        }
 
-            // Draw background
-            QColor bgColor = cell.bgColor.isValid() ? cell.bgColor : QColor(0, 0, 0);
-            painter.fillRect(cellRect, bgColor);
+        // Backgrounds first, so a wide character is not cut by the cell to its right
+        for (int col = 0; col < m_columns; ++col) {
+            const TerminalScreen::Cell& cell = col < cellCount ? cells[col] : blank;
+            painter.fillRect(getCellRect(row, col),
+                             QColor::fromRgb(m_theme.resolve(cell.bgColor)));
+        }
 
-            // Draw character
-            if (cell.character != ' ' && cell.character != QChar(0)) {
-                QColor fgColor = cell.fgColor.isValid() ? cell.fgColor : QColor(170, 170, 170);
-                painter.setPen(fgColor);
+        // Text goes out in runs of cells with the same colour and style, shaped once
+        // per distinct run by m_glyphs
+        const int lastCol = std::min(cellCount, m_columns);
+        int col = 0;
+        while (col < lastCol) {
+            const TerminalScreen::Cell& first = cells[col];
+            if (first.width == 0 || first.character == ' ' || first.character == 0) {
+                ++col;
+                continue;
+            }
 
-                QFont font = m_font;
-                font.setBold(cell.bold);
-                font.setItalic(cell.italic);
-                font.setUnderline(cell.underline);
-                painter.setFont(font);
+            const int start = col;
+            const int style = glyphStyle(first);
+            int next = col;  // where the run's layout puts the next character
+            text.clear();
+            while (col < lastCol) {
+                const TerminalScreen::Cell& cell = cells[col];
+                if (cell.width == 0 && col < next) {
+                    // Right half of a wide character in the run
+                    ++col;
+                    continue;
+                }
+                if (col != next || cell.width == 0 || cell.character == 0 ||
+                    cell.fgColor != first.fgColor || glyphStyle(cell) != style) {
+                    break;
+                }
+                cell.appendText(text, screen.clusters());
+                next += cell.width;
+                ++col;
+            }
 
-                painter.drawText(cellRect, Qt::AlignLeft | Qt::AlignTop, QString(cell.character));
+            while (text.endsWith(QLatin1Char(' '))) {
+                text.chop(1);
             }
+            painter.setPen(QColor::fromRgb(m_theme.resolve(first.fgColor)));
+            drawGlyphs(painter, getCellRect(row, start).topLeft(), text, style);
         }
     }
 
     // Draw cursor
     if (m_cursorVisible && m_hasFocus && screen.cursorVisible()) {
-        int cursorRow = screen.cursorRow();
+        int cursorRow = screen.cursorRow() + scrollOffset;
         int cursorCol = screen.cursorCol();
 
         if (cursorRow >= 0 && cursorRow < m_rows && cursorCol >= 0 && cursorCol < m_columns) {
+            // A wide character under the cursor gets a two-column cursor
+            const TerminalScreen::Cell& cell = screen.cellAt(screen.cursorRow(), cursorCol);
             QRect cursorRect = getCellRect(cursorRow, cursorCol);
-            painter.fillRect(cursorRect, QColor(170, 170, 170));
+            cursorRect.setWidth(m_charWidth * std::max(1, static_cast<int>(cell.width)));
+            painter.fillRect(cursorRect, QColor::fromRgb(m_theme.foreground));
 
             // Redraw character in inverse color
-            const TerminalScreen::Cell& cell = screen.cellAt(cursorRow, cursorCol);
-            if (cell.character != ' ' && cell.character != QChar(0)) {
-                painter.setPen(QColor(0, 0, 0));
-                painter.drawText(cursorRect, Qt::AlignLeft | Qt::AlignTop, QString(cell.character));
+            if (cell.character != ' ' && cell.character != 0 && cell.width != 0) {
+                painter.setPen(QColor::fromRgb(m_theme.background));
+                text.clear();
+                cell.appendText(text, screen.clusters());
+                drawGlyphs(painter, cursorRect.topLeft(), text, glyphStyle(cell));
             }
         }
     }
+
+    QStringList overlay;
+    if (m_metricsOverlayVisible && m_metrics) {
+        overlay << metricsOverlayLines();
+    }
+    if (m_latencyOverlayVisible && m_latencyTracker) {
+        overlay << latencyOverlayLines();
+    }
+    if (!overlay.isEmpty()) {
+        drawOverlay(painter, overlay);
+    }
+
+    // The frame is recorded as painted once the backing store has the new content;
+    // compositor and display latency are outside what the application can see
+    if (m_latencyTracker) {
+        m_latencyTracker->markPainted();
+    }
+    if (m_metrics) {
+        m_metrics->paintTimeNs.record(static_cast<quint64>(paintTimer.nsecsElapsed()));
+        m_metrics->framesRendered.add();
+    }
+    m_framePending = false;
+}
+
+QStringList TerminalView::latencyOverlayLines() const
+{
+    QStringList lines;
+    lines << QString("latency  p50 / p99 ms  (%1 probes)")
+                 .arg(m_latencyTracker->completedProbes());
+    for (int i = 0; i < LatencyTracker::SegmentCount; ++i) {
+        auto segment = static_cast<LatencyTracker::Segment>(i);
+        const Histogram& histogram = m_latencyTracker->histogram(segment);
+        lines << QString("%1 %2 / %3")
+                     .arg(QString::fromLatin1(LatencyTracker::segmentName(segment)), -14)
+                     .arg(histogram.percentile(50.0) / 1e6, 6, 'f', 2)
+                     .arg(histogram.percentile(99.0) / 1e6, 6, 'f', 2);
+    }
+    return lines;
+}
+
+QStringList TerminalView::metricsOverlayLines() const
+{
+    auto kib = [](qint64 bytes) { return QString::number(bytes / 1024.0, 'f', 1) + " KiB"; };
+    auto ms = [](const Histogram& histogram, double percent) {
+        return QString::number(histogram.percentile(percent) / 1e6, 'f', 2);
+    };
+
+    const SessionMetrics& m = *m_metrics;
+    QStringList lines;
+    lines << QString("session  %1").arg(m.name);
+    lines << QString("in       %1  (%2 reads)")
+                 .arg(kib(static_cast<qint64>(m.bytesIn.value())))
+                 .arg(m.readCalls.value());
+    lines << QString("out      %1  (%2 writes)")
+                 .arg(kib(static_cast<qint64>(m.bytesOut.value())))
+                 .arg(m.writeCalls.value());
+    lines << QString("queues   in %1, out %2 chunks")
+                 .arg(kib(m.inboundPendingBytes.value()))
+                 .arg(m.writeQueueDepth.value());
+    lines << QString("parse    p50 %1 / p99 %2 ms")
+                 .arg(ms(m.parseTimeNs, 50.0), ms(m.parseTimeNs, 99.0));
+    lines << QString("paint    p50 %1 / p99 %2 ms")
+                 .arg(ms(m.paintTimeNs, 50.0), ms(m.paintTimeNs, 99.0));
+    lines << QString("frames   %1 rendered, %2 skipped")
+                 .arg(m.framesRendered.value())
+                 .arg(m.framesSkipped.value());
+    lines << QString("history  %1").arg(kib(m.scrollbackBytes.value()));
+
+    // Process-wide counts, only in ENABLE_ALLOC_TRACKING builds
+    if (AllocTracker::isCompiledIn()) {
+        lines << QString("allocs   all sessions");
+        for (int i = 0; i < AllocTracker::SubsystemCount; ++i) {
+            auto subsystem = static_cast<AllocTracker::Subsystem>(i);
+            AllocTracker::Counts counts = AllocTracker::counts(subsystem);
+            lines << QString("  %1 %2  (%3)")
+                         .arg(QString::fromLatin1(AllocTracker::subsystemName(subsystem)), -11)
+                         .arg(counts.allocations)
+                         .arg(kib(static_cast<qint64>(counts.bytes)));
+        }
+    }
+    return lines;
+}
+
+void TerminalView::drawGlyphs(QPainter& painter, const QPoint& topLeft, const QString& text,
+                              int style)
+{
+    const QPointF baseline(topLeft.x(), topLeft.y() + m_charAscent);
+    for (const QGlyphRun& run : m_glyphs.glyphs(text, style)) {
+        painter.drawGlyphRun(baseline, run);
+    }
+}
+
+void TerminalView::drawOverlay(QPainter& painter, const QStringList& lines)
+{
+    QFont font = m_font;
+    font.setBold(false);
+    font.setItalic(false);
+    font.setUnderline(false);
+    painter.setFont(font);
+
+    QFontMetrics fm(font);
+    int textWidth = 0;
+    for (const QString& line : lines) {
+        textWidth = std::max(textWidth, fm.horizontalAdvance(line));
+    }
+
+    // Top-right corner, translucent so the terminal underneath stays readable
+    const int margin = 6;
+    QRect box(width() - textWidth - 3 * margin, margin, textWidth + 2 * margin,
+              lines.size() * fm.height() + 2 * margin);
+    painter.fillRect(box, QColor(0, 0, 0, 200));
+    painter.setPen(QColor(85, 255, 85));
+    painter.drawRect(box.adjusted(0, 0, -1, -1));
+
+    for (int i = 0; i < lines.size(); ++i) {
+        QRect lineRect(box.left() + margin, box.top() + margin + i * fm.height(), textWidth,
+                       fm.height());
+        painter.drawText(lineRect, Qt::AlignLeft | Qt::AlignTop, lines[i]);
+    }
 }
 
 void TerminalView::keyPressEvent(QKeyEvent* event)
 {
+    // Shift+PageUp/PageDown page through scrollback locally
+    if (event->modifiers() & Qt::ShiftModifier) {
+        if (event->key() == Qt::Key_PageUp) {
+            scrollViewBy(std::max(1, m_rows - 1));
+            event->accept();
+            return;
+        }
+        if (event->key() == Qt::Key_PageDown) {
+            scrollViewBy(-std::max(1, m_rows - 1));
+            event->accept();
+            return;
+        }
+    }
+
     QString data = keyEventToString(event);
     if (!data.isEmpty()) {
+        scrollToBottom();
+        if (m_latencyTracker) {
+            m_latencyTracker->markKeyPress();
+        }
         emit sendData(data);
     }
     event->accept();
@@ -199,6 +530,16 @@ void TerminalView::mouseMoveEvent(QMouseEvent* event)
     QWidget::mouseMoveEvent(event);
 }
 
+void TerminalView::wheelEvent(QWheelEvent* event)
+{
+    // Three rows per wheel notch
+    int notches = event->angleDelta().y() / 120;
+    if (notches != 0) {
+        scrollViewBy(notches * 3);
+    }
+    event->accept();
+}
+
 void TerminalView::focusInEvent(QFocusEvent* event)
 {
     m_hasFocus = true;
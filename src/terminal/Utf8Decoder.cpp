@@ -0,0 +1,111 @@
+#include "Utf8Decoder.h"
+
+namespace {
+
+constexpr char16_t ReplacementCharacter = 0xfffd;
+
+bool isContinuation(uchar byte)
+{
+    return (byte & 0xc0) == 0x80;
+}
+
+// Bytes in the sequence a lead byte starts; 1 for ASCII and stray continuation bytes
+int sequenceLength(uchar lead)
+{
+    return lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc0 ? 2 : 1;
+}
+
+// Length of the prefix of data that ends on a UTF-8 character boundary
+int completeLength(const uchar* data, int size)
+{
+    // Walk back over at most three continuation bytes to the lead byte
+    for (int i = size - 1; i >= 0 && i >= size - 4; --i) {
+        if (isContinuation(data[i])) {
+            continue;
+        }
+        return size - i < sequenceLength(data[i]) ? i : size;
+    }
+    return size;
+}
+
+// Decodes [pos, end) to UTF-16 at dst and returns the end of the output. Each
+// malformed or truncated sequence becomes one U+FFFD.
+char16_t* decodeRun(const uchar* pos, const uchar* end, char16_t* dst)
+{
+    static const char32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+
+    while (pos < end) {
+        const uchar lead = *pos;
+        if (lead < 0x80) {
+            *dst++ = lead;
+            ++pos;
+            continue;
+        }
+
+        const int length = sequenceLength(lead);
+        int have = 1;
+        while (have < length && pos + have < end && isContinuation(pos[have])) {
+            ++have;
+        }
+        if (length == 1 || lead > 0xf4 || have < length) {
+            *dst++ = ReplacementCharacter;
+            pos += have;
+            continue;
+        }
+
+        char32_t cp = lead & (0x7f >> length);
+        for (int i = 1; i < length; ++i) {
+            cp = (cp << 6) | (pos[i] & 0x3f);
+        }
+        pos += length;
+
+        // Overlong forms, UTF-16 surrogates and values past U+10FFFF
+        if (cp < minimum[length] || cp > 0x10ffff || (cp >= 0xd800 && cp < 0xe000)) {
+            *dst++ = ReplacementCharacter;
+        } else if (cp >= 0x10000) {
+            *dst++ = QChar::highSurrogate(cp);
+            *dst++ = QChar::lowSurrogate(cp);
+        } else {
+            *dst++ = char16_t(cp);
+        }
+    }
+    return dst;
+}
+
+} // namespace
+
+namespace Unicode {
+
+void Utf8Decoder::decode(const char* data, int size, QString& out)
+{
+    // At most one UTF-16 unit per input byte, held-back bytes included
+    out.resize(size + m_pendingSize);
+    char16_t* const begin = reinterpret_cast<char16_t*>(out.data());
+    char16_t* dst = begin;
+    const uchar* pos = reinterpret_cast<const uchar*>(data);
+    const uchar* const end = pos + size;
+
+    if (m_pendingSize > 0) {
+        // Complete the held-back character with the continuation bytes that follow it
+        const int length = sequenceLength(uchar(m_pending[0]));
+        while (m_pendingSize < length && pos < end && isContinuation(*pos)) {
+            m_pending[m_pendingSize++] = char(*pos++);
+        }
+        if (m_pendingSize == length || pos < end) {
+            const uchar* held = reinterpret_cast<const uchar*>(m_pending);
+            dst = decodeRun(held, held + m_pendingSize, dst);
+            m_pendingSize = 0;
+        }
+    }
+
+    // Hold back a character cut off at the end; it is completed by the next chunk
+    const uchar* complete = pos + completeLength(pos, int(end - pos));
+    dst = decodeRun(pos, complete, dst);
+    while (complete < end) {
+        m_pending[m_pendingSize++] = char(*complete++);
+    }
+
+    out.resize(int(dst - begin));
+}
+
+} // namespace Unicode
@@ -3,6 +3,10 @@
 #include "SSHConnection.h"
 #include "SSHAuthenticator.h"
 #include "SSHWorkerThread.h"
+#include "LocalPtySession.h"
+#include "LatencyTracker.h"
+#include "Metrics.h"
+#include "Tracer.h"
 #include "Logger.h"
 #include "ErrorDialog.h"
 #include "TerminalView.h"
@@ -16,6 +20,12 @@
 #include <QFont>
 #include <QPushButton>
 #include <QTabBar>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), m_tabWidget(nullptr), m_welcomeWidget(nullptr), m_savedConnectionsList(nullptr)
 {
@@ -33,7 +43,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), m_tabWidget(nullp
     // Set window properties
     setWindowTitle("SSH Client");
     resize(1024, 768);
-    setMinimumSize(800, 600);
+    setMinimumSize(400, 300);
 
     // Ensure window is visible and raised
     raise();
@@ -61,6 +71,7 @@ MainWindow::~MainWindow()
             }
         }
         delete tabData.worker;
+        releaseInstrumentation(tabData);
 
         if (tabData.connection) {
             qDebug(ui) << "Disconnecting SSH connection for tab" << i;
@@ -77,8 +88,12 @@ void MainWindow::addNewTab(const QString& title)
 {
     TabData tabData;
     tabData.terminal = new TerminalView();
+    tabData.terminal->setTheme(*m_theme);
+    tabData.terminal->setLigaturesEnabled(m_ligaturesAction->isChecked());
     tabData.connection = nullptr;
     tabData.worker = nullptr;
+    tabData.latency = nullptr;
+    tabData.metrics = nullptr;
 
     m_tabs.append(tabData);
 
@@ -137,6 +152,11 @@ void MainWindow::onNewConnection()
     }
 }
 
+void MainWindow::onNewLocalTerminal()
+{
+    openLocalTerminal();
+}
+
 void MainWindow::onCloseTab()
 {
     closeCurrentTab();
@@ -178,6 +198,125 @@ void MainWindow::onAbout()
                        "- Terminal emulation with ANSI support");
 }
 
+void MainWindow::onToggleLatencyOverlay(bool visible)
+{
+    for (const TabData& tabData : m_tabs) {
+        tabData.terminal->setLatencyOverlayVisible(visible);
+    }
+}
+
+void MainWindow::onDumpLatencyStats()
+{
+    QJsonArray tabs;
+    for (int i = 0; i < m_tabs.size(); ++i) {
+        const TabData& tabData = m_tabs[i];
+        if (!tabData.latency) {
+            continue;
+        }
+
+        QJsonObject tab = tabData.latency->toJson();
+        tab["tab"] = m_tabWidget->tabText(m_tabWidget->indexOf(tabData.terminal));
+        tabs.append(tab);
+    }
+
+    QString path = writeDiagnosticsFile("latency", QJsonDocument(tabs).toJson());
+    if (!path.isEmpty()) {
+        showStatusMessage("Latency statistics written to " + path, 5000);
+    }
+}
+
+void MainWindow::onThemeSelected(QAction* action)
+{
+    const ColorTheme* theme = ColorTheme::find(action->data().toString());
+    if (!theme) {
+        return;
+    }
+
+    m_theme = theme;
+    for (const TabData& tabData : m_tabs) {
+        tabData.terminal->setTheme(*theme);
+    }
+}
+
+void MainWindow::onToggleLigatures(bool enabled)
+{
+    for (const TabData& tabData : m_tabs) {
+        tabData.terminal->setLigaturesEnabled(enabled);
+    }
+}
+
+void MainWindow::onToggleMetricsOverlay(bool visible)
+{
+    for (const TabData& tabData : m_tabs) {
+        tabData.terminal->setMetricsOverlayVisible(visible);
+    }
+}
+
+void MainWindow::onDumpMetrics()
+{
+    QJsonDocument document(MetricsRegistry::instance().toJson());
+    QString path = writeDiagnosticsFile("metrics", document.toJson());
+    if (!path.isEmpty()) {
+        showStatusMessage("Metrics written to " + path, 5000);
+    }
+}
+
+void MainWindow::onToggleTracing(bool enabled)
+{
+    if (enabled) {
+        Tracer::clear();
+        Tracer::setEnabled(true);
+        qInfo(metrics) << "Pipeline tracing started";
+        showStatusMessage("Recording pipeline trace");
+        return;
+    }
+
+    Tracer::setEnabled(false);
+    QString path = writeDiagnosticsFile("trace", Tracer::exportChromeTrace());
+    if (!path.isEmpty()) {
+        showStatusMessage("Trace written to " + path + " (open in ui.perfetto.dev)", 5000);
+    }
+}
+
+QString MainWindow::writeDiagnosticsFile(const QString& prefix, const QByteArray& contents)
+{
+    // Written next to the application log so it ends up in bug reports with it
+    QString dir = QFileInfo(Logger::instance().logFilePath()).absolutePath();
+    QString path = QDir(dir).filePath(
+        prefix + "-" + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json");
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning(metrics) << "Cannot write" << path << file.errorString();
+        showStatusMessage("Cannot write " + path + ": " + file.errorString(), 5000);
+        return QString();
+    }
+
+    file.write(contents);
+    qInfo(metrics) << "Diagnostics written to" << path;
+    return path;
+}
+
+void MainWindow::releaseInstrumentation(TabData& tabData)
+{
+    if (tabData.latency) {
+        tabData.terminal->setLatencyTracker(nullptr);
+        delete tabData.latency;
+        tabData.latency = nullptr;
+    }
+
+    if (tabData.metrics) {
+        // Leave a per-session summary in the log so production issues can be triaged
+        qInfo(metrics).noquote()
+            << "Session" << tabData.metrics->name << "summary:"
+            << QJsonDocument(tabData.metrics->toJson()).toJson(QJsonDocument::Compact);
+        MetricsRegistry::instance().remove(tabData.metrics);
+        tabData.terminal->setMetrics(nullptr);
+        delete tabData.metrics;
+        tabData.metrics = nullptr;
+    }
+}
+
 void MainWindow::onTabCloseRequested(int index)
 {
     if (index < 0 || index >= m_tabs.size()) {
@@ -187,6 +326,11 @@ void MainWindow::onTabCloseRequested(int index)
     qInfo(ui) << "Closing tab" << index;
     TabData& tabData = m_tabs[index];
 
+    if (tabData.worker) {
+        qInfo(ui) << "Tab" << index << "hit inbound backpressure"
+                  << tabData.worker->backpressureCount() << "times";
+    }
+
     // Stop worker thread
     if (tabData.worker && tabData.worker->isRunning()) {
         qDebug(ui) << "Stopping worker thread for tab" << index;
@@ -201,6 +345,9 @@ void MainWindow::onTabCloseRequested(int index)
         tabData.worker = nullptr;
     }
 
+    // The session thread is gone, so nothing else can reach the instruments
+    releaseInstrumentation(tabData);
+
     // Delete connection
     if (tabData.connection) {
         qDebug(ui) << "Disconnecting SSH connection for tab" << index;
@@ -269,25 +416,64 @@ void MainWindow::handleConnected()
     }
 
     TabData& tabData = m_tabs[index];
+    attachSession(tabData, new SSHWorkerThread(tabData.connection));
+}
+
+void MainWindow::openLocalTerminal(const QString& program, const QStringList& arguments)
+{
+    if (!LocalPtySession::isSupported()) {
+        ErrorDialog::showError(this, "Local Terminal",
+                               "Local terminal sessions are not supported on this platform",
+                               ErrorDialog::ErrorType::Unknown);
+        return;
+    }
 
-    // Create worker thread
-    tabData.worker = new SSHWorkerThread(tabData.connection);
+    hideWelcomeTab();
+    addNewTab(program.isEmpty() ? QString("Local") : program);
 
-    // Connect worker signals
-    connect(tabData.worker, &SSHWorkerThread::dataReceived, this,
-            &MainWindow::handleDataReceived);
-    connect(tabData.worker, &SSHWorkerThread::error, this, &MainWindow::handleError);
-    connect(tabData.worker, &SSHWorkerThread::disconnected, this,
-            &MainWindow::handleDisconnected);
+    int index = m_tabWidget->currentIndex();
+    if (index < 0 || index >= m_tabs.size()) {
+        return;
+    }
 
-    // Connect terminal to worker
-    connect(tabData.terminal, &TerminalView::sendData,
-            [worker = tabData.worker](const QString& data) {
-                worker->writeData(data.toUtf8());
-            });
+    attachSession(m_tabs[index], new LocalPtySession(program, arguments));
+    showStatusMessage("Local terminal started", 3000);
+}
 
-    // Start worker
-    tabData.worker->start();
+void MainWindow::attachSession(TabData& tabData, TerminalSession* session)
+{
+    tabData.worker = session;
+
+    // Every session gets a latency tracker; probing costs a few atomics per keystroke
+    tabData.latency = new LatencyTracker();
+    tabData.terminal->setLatencyTracker(tabData.latency);
+    tabData.terminal->setLatencyOverlayVisible(m_latencyOverlayAction->isChecked());
+    session->setLatencyTracker(tabData.latency);
+
+    // Metrics are cheap enough to stay on; the registry makes them dumpable
+    QString name = m_tabWidget->tabText(m_tabWidget->indexOf(tabData.terminal));
+    tabData.metrics = new SessionMetrics(name);
+    tabData.terminal->setMetrics(tabData.metrics);
+    tabData.terminal->setMetricsOverlayVisible(m_metricsOverlayAction->isChecked());
+    session->setMetrics(tabData.metrics);
+    MetricsRegistry::instance().add(tabData.metrics);
+
+    // Connect session signals
+    connect(session, &TerminalSession::dataReceived, this, &MainWindow::handleDataReceived);
+    connect(session, &TerminalSession::error, this, &MainWindow::handleError);
+    connect(session, &TerminalSession::disconnected, this, &MainWindow::handleDisconnected);
+
+    // Connect terminal to session
+    connect(tabData.terminal, &TerminalView::sendData, session,
+            [session](const QString& data) { session->writeData(data.toUtf8()); });
+
+    // Request the PTY at the real view size and forward settled resizes
+    session->setTerminalSize(tabData.terminal->rows(), tabData.terminal->columns());
+    connect(tabData.terminal, &TerminalView::terminalSizeSettled, session,
+            &TerminalSession::setTerminalSize, Qt::DirectConnection);
+
+    // Start session
+    session->start();
 }
 
 void MainWindow::handleDisconnected()
@@ -342,9 +528,16 @@ void MainWindow::handleError(const QString& error)
 
 void MainWindow::handleDataReceived(const QByteArray& data)
 {
-    int index = m_tabWidget->currentIndex();
-    if (index >= 0 && index < m_tabs.size()) {
-        m_tabs[index].terminal->displayOutput(QString::fromUtf8(data));
+    // Route data to the session that produced it, not to whichever tab is current
+    QObject* source = sender();
+    for (const TabData& tabData : m_tabs) {
+        if (tabData.worker && tabData.worker == source) {
+            tabData.terminal->displayOutput(data);
+
+            // Release flow-control credit only after the emulator has consumed the chunk
+            tabData.worker->acknowledgeData(data.size());
+            break;
+        }
     }
 }
 
@@ -369,6 +562,7 @@ void MainWindow::createMenus()
     QMenu* fileMenu = menuBar()->addMenu("&File");
     fileMenu->setObjectName("fileMenu");
     fileMenu->addAction(m_newConnectionAction);
+    fileMenu->addAction(m_newLocalTerminalAction);
     fileMenu->addAction(m_closeTabAction);
     fileMenu->addSeparator();
     fileMenu->addAction(m_exitAction);
@@ -379,6 +573,22 @@ void MainWindow::createMenus()
     editMenu->addAction(m_copyAction);
     editMenu->addAction(m_pasteAction);
 
+    // View menu
+    QMenu* viewMenu = menuBar()->addMenu("&View");
+    viewMenu->setObjectName("viewMenu");
+    viewMenu->addAction(m_latencyOverlayAction);
+    viewMenu->addAction(m_dumpLatencyAction);
+    viewMenu->addSeparator();
+    viewMenu->addAction(m_metricsOverlayAction);
+    viewMenu->addAction(m_dumpMetricsAction);
+    viewMenu->addSeparator();
+    viewMenu->addAction(m_traceAction);
+    viewMenu->addSeparator();
+    QMenu* themeMenu = viewMenu->addMenu("Colour &Theme");
+    themeMenu->setObjectName("themeMenu");
+    themeMenu->addActions(m_themeGroup->actions());
+    viewMenu->addAction(m_ligaturesAction);
+
     // Help menu
     QMenu* helpMenu = menuBar()->addMenu("&Help");
     helpMenu->setObjectName("helpMenu");
@@ -392,6 +602,12 @@ void MainWindow::createActions()
     m_newConnectionAction->setShortcut(QKeySequence::New);
     connect(m_newConnectionAction, &QAction::triggered, this, &MainWindow::onNewConnection);
 
+    m_newLocalTerminalAction = new QAction("New &Local Terminal", this);
+    m_newLocalTerminalAction->setObjectName("newLocalTerminalAction");
+    m_newLocalTerminalAction->setShortcut(QKeySequence("Ctrl+Shift+T"));
+    connect(m_newLocalTerminalAction, &QAction::triggered, this,
+            &MainWindow::onNewLocalTerminal);
+
     m_closeTabAction = new QAction("&Close Tab", this);
     m_closeTabAction->setObjectName("closeTabAction");
     m_closeTabAction->setShortcut(QKeySequence::Close);
@@ -415,6 +631,54 @@ void MainWindow::createActions()
     m_aboutAction = new QAction("&About", this);
     m_aboutAction->setObjectName("aboutAction");
     connect(m_aboutAction, &QAction::triggered, this, &MainWindow::onAbout);
+
+    m_latencyOverlayAction = new QAction("&Latency Overlay", this);
+    m_latencyOverlayAction->setObjectName("latencyOverlayAction");
+    m_latencyOverlayAction->setCheckable(true);
+    m_latencyOverlayAction->setShortcut(QKeySequence("Ctrl+Shift+L"));
+    connect(m_latencyOverlayAction, &QAction::toggled, this,
+            &MainWindow::onToggleLatencyOverlay);
+
+    m_dumpLatencyAction = new QAction("&Dump Latency Statistics", this);
+    m_dumpLatencyAction->setObjectName("dumpLatencyAction");
+    connect(m_dumpLatencyAction, &QAction::triggered, this, &MainWindow::onDumpLatencyStats);
+
+    m_metricsOverlayAction = new QAction("Session &Statistics Overlay", this);
+    m_metricsOverlayAction->setObjectName("metricsOverlayAction");
+    m_metricsOverlayAction->setCheckable(true);
+    m_metricsOverlayAction->setShortcut(QKeySequence("Ctrl+Shift+M"));
+    connect(m_metricsOverlayAction, &QAction::toggled, this,
+            &MainWindow::onToggleMetricsOverlay);
+
+    m_dumpMetricsAction = new QAction("Dump &Metrics", this);
+    m_dumpMetricsAction->setObjectName("dumpMetricsAction");
+    connect(m_dumpMetricsAction, &QAction::triggered, this, &MainWindow::onDumpMetrics);
+
+    m_traceAction = new QAction("Record Pipeline &Trace", this);
+    m_traceAction->setObjectName("traceAction");
+    m_traceAction->setCheckable(true);
+    m_traceAction->setChecked(Tracer::isEnabled());
+#ifndef SSH_CLIENT_TRACING
+    m_traceAction->setEnabled(false);
+#endif
+    connect(m_traceAction, &QAction::toggled, this, &MainWindow::onToggleTracing);
+
+    // One entry per built-in and user theme
+    m_theme = &ColorTheme::defaultTheme();
+    m_themeGroup = new QActionGroup(this);
+    m_themeGroup->setExclusive(true);
+    for (const ColorTheme& theme : ColorTheme::available()) {
+        QAction* action = m_themeGroup->addAction(theme.name);
+        action->setData(theme.name);
+        action->setCheckable(true);
+        action->setChecked(&theme == m_theme);
+    }
+    connect(m_themeGroup, &QActionGroup::triggered, this, &MainWindow::onThemeSelected);
+
+    m_ligaturesAction = new QAction("Font &Ligatures", this);
+    m_ligaturesAction->setObjectName("ligaturesAction");
+    m_ligaturesAction->setCheckable(true);
+    connect(m_ligaturesAction, &QAction::toggled, this, &MainWindow::onToggleLigatures);
 }
 
 void MainWindow::createStatusBar()
@@ -0,0 +1,248 @@
+#include "BinaryLog.h"
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QtEndian>
+#include <chrono>
+#include <cstring>
+
+namespace BinaryLog {
+
+namespace {
+
+struct FormatRegistry {
+    QMutex mutex;
+    QVector<QByteArray> formats;
+};
+
+FormatRegistry& formatRegistry()
+{
+    static FormatRegistry registry;
+    return registry;
+}
+
+template <typename T>
+void appendLittleEndian(QByteArray& out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T readLittleEndian(const char* data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+} // namespace
+
+QByteArray fileHeader()
+{
+    QByteArray header(Magic, sizeof(Magic));
+    appendLittleEndian<quint32>(header, Version);
+    appendLittleEndian<quint32>(header, 0);
+    return header;
+}
+
+bool checkFileHeader(const char* data, qint64 size)
+{
+    return size >= FileHeaderSize && std::memcmp(data, Magic, sizeof(Magic)) == 0 &&
+           readLittleEndian<quint32>(data + sizeof(Magic)) == Version;
+}
+
+void appendRecord(QByteArray& out, const RecordHeader& header, const QByteArray& payload)
+{
+    appendLittleEndian<quint32>(out, RecordHeaderSize + payload.size());
+    appendLittleEndian<quint8>(out, static_cast<quint8>(header.kind));
+    appendLittleEndian<quint8>(out, header.level);
+    appendLittleEndian<quint16>(out, header.category);
+    appendLittleEndian<quint32>(out, header.format);
+    appendLittleEndian<quint64>(out, header.timestampUs);
+    out += payload;
+}
+
+bool readRecord(const char* data, qint64 size, qint64& offset, RecordHeader& header,
+                QByteArray& payload)
+{
+    if (offset + RecordHeaderSize > size) {
+        return false;
+    }
+
+    const char* p = data + offset;
+    header.length = readLittleEndian<quint32>(p);
+    if (header.length < RecordHeaderSize || offset + header.length > size) {
+        return false;
+    }
+
+    header.kind = static_cast<RecordKind>(static_cast<quint8>(p[4]));
+    header.level = static_cast<quint8>(p[5]);
+    header.category = readLittleEndian<quint16>(p + 6);
+    header.format = readLittleEndian<quint32>(p + 8);
+    header.timestampUs = readLittleEndian<quint64>(p + 12);
+    payload = QByteArray(p + RecordHeaderSize, static_cast<int>(header.length) - RecordHeaderSize);
+
+    offset += header.length;
+    return true;
+}
+
+quint32 registerFormatString(const char* format)
+{
+    FormatRegistry& registry = formatRegistry();
+    QMutexLocker locker(&registry.mutex);
+    registry.formats.append(QByteArray(format));
+    return static_cast<quint32>(registry.formats.size());
+}
+
+QByteArray formatString(quint32 id)
+{
+    FormatRegistry& registry = formatRegistry();
+    QMutexLocker locker(&registry.mutex);
+    if (id == 0 || id > static_cast<quint32>(registry.formats.size())) {
+        return QByteArray();
+    }
+    return registry.formats[static_cast<int>(id) - 1];
+}
+
+void encodeInt(QByteArray& out, qint64 value)
+{
+    out += static_cast<char>(ArgType::Int);
+    appendLittleEndian<qint64>(out, value);
+}
+
+void encodeUInt(QByteArray& out, quint64 value)
+{
+    out += static_cast<char>(ArgType::UInt);
+    appendLittleEndian<quint64>(out, value);
+}
+
+void encodeDouble(QByteArray& out, double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out += static_cast<char>(ArgType::Double);
+    appendLittleEndian<quint64>(out, bits);
+}
+
+void encodeString(QByteArray& out, const QByteArray& utf8)
+{
+    out += static_cast<char>(ArgType::String);
+    appendLittleEndian<quint32>(out, static_cast<quint32>(utf8.size()));
+    out += utf8;
+}
+
+QStringList decodeArgs(const QByteArray& payload)
+{
+    QStringList args;
+    const char* data = payload.constData();
+    int size = payload.size();
+    int offset = 0;
+
+    while (offset < size) {
+        auto type = static_cast<ArgType>(static_cast<quint8>(data[offset++]));
+        if (type == ArgType::String) {
+            if (offset + 4 > size) {
+                break;
+            }
+            quint32 length = readLittleEndian<quint32>(data + offset);
+            offset += 4;
+            if (length > static_cast<quint32>(size - offset)) {
+                break;
+            }
+            args << QString::fromUtf8(data + offset, static_cast<int>(length));
+            offset += static_cast<int>(length);
+            continue;
+        }
+
+        if (offset + 8 > size) {
+            break;
+        }
+        quint64 bits = readLittleEndian<quint64>(data + offset);
+        offset += 8;
+
+        if (type == ArgType::Int) {
+            args << QString::number(static_cast<qint64>(bits));
+        } else if (type == ArgType::UInt) {
+            args << QString::number(bits);
+        } else if (type == ArgType::Double) {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            args << QString::number(value);
+        } else {
+            args << QStringLiteral("<?>");
+        }
+    }
+
+    return args;
+}
+
+QString render(const QString& format, const QStringList& args)
+{
+    QString result;
+    result.reserve(format.size() + 16 * args.size());
+
+    for (int i = 0; i < format.size(); ++i) {
+        QChar ch = format[i];
+        if (ch != '%' || i + 1 >= format.size() || !format[i + 1].isDigit()) {
+            result += ch;
+            continue;
+        }
+
+        int number = format[i + 1].digitValue();
+        int end = i + 2;
+        if (end < format.size() && format[end].isDigit()) {
+            number = number * 10 + format[end].digitValue();
+            ++end;
+        }
+
+        if (number >= 1 && number <= args.size()) {
+            result += args[number - 1];
+        } else {
+            result += format.mid(i, end - i);
+        }
+        i = end - 1;
+    }
+
+    return result;
+}
+
+QByteArray formatLine(quint64 timestampUs, int level, const char* category,
+                      const QString& message)
+{
+    const char* levelName = "DEBUG";
+    switch (level) {
+    case QtDebugMsg:
+        levelName = "DEBUG";
+        break;
+    case QtInfoMsg:
+        levelName = "INFO ";
+        break;
+    case QtWarningMsg:
+        levelName = "WARN ";
+        break;
+    case QtCriticalMsg:
+        levelName = "ERROR";
+        break;
+    case QtFatalMsg:
+        levelName = "FATAL";
+        break;
+    }
+
+    QString timestamp =
+        QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(timestampUs / 1000))
+            .toString("yyyy-MM-dd hh:mm:ss.zzz");
+    QString line = QString("[%1] [%2] [%3] %4")
+                       .arg(timestamp, QLatin1String(levelName), QLatin1String(category),
+                            message);
+    return line.toUtf8() + '\n';
+}
+
+quint64 currentTimestampUs()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count());
+}
+
+} // namespace BinaryLog
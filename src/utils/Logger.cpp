@@ -2,7 +2,11 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QDateTime>
-#include <QTextStream>
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
 
 // Define logging categories
 Q_LOGGING_CATEGORY(sshConnection, "ssh.connection")
@@ -10,6 +14,17 @@ Q_LOGGING_CATEGORY(sshAuth, "ssh.auth")
 Q_LOGGING_CATEGORY(terminal, "terminal")
 Q_LOGGING_CATEGORY(ui, "ui")
 Q_LOGGING_CATEGORY(storage, "storage")
+Q_LOGGING_CATEGORY(metrics, "metrics")
+
+namespace {
+// Records written per batch before the file is flushed and checked for rotation
+constexpr int WriteBatchSize = 256;
+// Idle writer wake-up interval; bounds the delay of a wake-up that raced with sleeping
+constexpr unsigned long WriterIdleWaitMs = 100;
+// Delay before trying again to open a binary log that could not be opened
+constexpr int MinReopenDelayMs = 1000;
+constexpr int MaxReopenDelayMs = 60000;
+} // namespace
 
 Logger* Logger::s_instance = nullptr;
 
@@ -21,15 +36,21 @@ Logger& Logger::instance()
     return *s_instance;
 }
 
-Logger::Logger() : m_maxFileSize(10 * 1024 * 1024), m_maxFiles(5) // 10MB, 5 files
+Logger::Logger()
+    : m_binaryMode(false), m_maxFileSize(10 * 1024 * 1024), m_maxFiles(5), // 10MB, 5 files
+      m_binaryRetryAtUs(0), m_binaryRetryDelayMs(0), m_queue(QueueCapacity), m_dropped(0),
+      m_reportedDropped(0), m_writer(nullptr),
+      m_writerRunning(0), m_writerIdle(0), m_stopRequested(0)
 {
 }
 
 Logger::~Logger()
 {
+    shutdown();
     if (m_logFile.isOpen()) {
         m_logFile.close();
     }
+    m_binaryFile.close();
 }
 
 void Logger::initialize()
@@ -37,7 +58,16 @@ void Logger::initialize()
     // Set default log path
     QString defaultPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir().mkpath(defaultPath);
-    setupFileLogging(defaultPath + "/ssh-client.log");
+    setupFileLogging(defaultPath + (m_binaryMode ? "/ssh-client.blog" : "/ssh-client.log"));
+
+    // Start the writer before any message can be queued for it
+    if (!m_writer) {
+        m_stopRequested.storeRelease(0);
+        m_writer = new Writer(this);
+        m_writer->setObjectName("LogWriter");
+        m_writerRunning.storeRelease(1);
+        m_writer->start(QThread::LowPriority);
+    }
 
     // Install message handler
     qInstallMessageHandler(Logger::messageHandler);
@@ -50,19 +80,37 @@ void Logger::setupFileLogging(const QString& logPath)
     if (m_logFile.isOpen()) {
         m_logFile.close();
     }
+    m_binaryFile.close();
 
     m_logPath = logPath;
+
+    if (m_binaryMode) {
+        // Keep earlier sessions: the previous file is rotated away instead of truncated
+        if (QFile::exists(getLogFileName(0))) {
+            rotateLogFiles();
+        } else {
+            openBinaryFile();
+        }
+        return;
+    }
+
     m_logFile.setFileName(getLogFileName(0));
 
     if (m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
         // Log startup
-        QTextStream stream(&m_logFile);
-        stream << "\n=== Log started at " << QDateTime::currentDateTime().toString(Qt::ISODate)
-               << " ===\n";
-        stream.flush();
+        QByteArray banner = "\n=== Log started at " +
+                            QDateTime::currentDateTime().toString(Qt::ISODate).toUtf8() +
+                            " ===\n";
+        m_logFile.write(banner);
+        m_logFile.flush();
     }
 }
 
+void Logger::setBinaryMode(bool enabled)
+{
+    m_binaryMode = enabled;
+}
+
 void Logger::setMaxFileSize(qint64 maxSize)
 {
     m_maxFileSize = maxSize;
@@ -78,63 +126,306 @@ QString Logger::logFilePath() const
     return m_logPath;
 }
 
+bool Logger::flush(int timeoutMs)
+{
+    if (!m_writerRunning.loadAcquire()) {
+        return true;
+    }
+
+    const quint64 target = m_queue.pushed();
+    QDeadlineTimer deadline(timeoutMs);
+    while (m_queue.consumed() < target) {
+        if (deadline.hasExpired()) {
+            return false;
+        }
+        wakeWriter();
+        QThread::msleep(1);
+    }
+    return true;
+}
+
+void Logger::shutdown()
+{
+    if (!m_writer) {
+        return;
+    }
+
+    m_stopRequested.storeRelease(1);
+    wakeWriter();
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+}
+
 void Logger::messageHandler(QtMsgType type, const QMessageLogContext& context,
                              const QString& msg)
 {
-    Logger& logger = Logger::instance();
-    QMutexLocker locker(&logger.m_mutex);
+    // Only the message text is built on the calling thread; timestamps are formatted
+    // by the writer
+    Record record;
+    record.timestampUs = BinaryLog::currentTimestampUs();
+    record.type = type;
+    qstrncpy(record.category, context.category ? context.category : "default",
+             sizeof(record.category));
+    record.message = msg;
+
+    Logger::instance().submit(std::move(record));
+}
 
-    // Check file size and rotate if needed
-    if (logger.m_logFile.isOpen() && logger.m_logFile.size() > logger.m_maxFileSize) {
-        logger.rotateLogFiles();
+void Logger::logStructured(const char* category, QtMsgType type, quint32 formatId,
+                           QByteArray&& args)
+{
+    Record record;
+    record.timestampUs = BinaryLog::currentTimestampUs();
+    record.type = type;
+    qstrncpy(record.category, category ? category : "default", sizeof(record.category));
+    record.formatId = formatId;
+    record.args = std::move(args);
+
+    submit(std::move(record));
+}
+
+void Logger::submit(Record&& record)
+{
+    QtMsgType type = record.type;
+
+    if (!m_writerRunning.loadAcquire()) {
+        // Before initialize() or after shutdown(): write in place
+        QMutexLocker locker(&m_mutex);
+        writeRecord(record);
+        m_logFile.flush();
+    } else {
+        enqueue(std::move(record));
     }
 
-    // Format message
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
-    QString typeStr;
+    if (type == QtFatalMsg) {
+        flush();
+        abort();
+    }
+}
+
+void Logger::enqueue(Record&& record)
+{
+    // Never wait for the writer: a full ring means the writer is behind, and stalling
+    // an I/O thread on it would be worse than losing debug output
+    if (!m_queue.tryPush(std::move(record))) {
+        m_dropped.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    // The writer may have stopped since submit() saw it running, after its last drain
+    // had already passed this record. This fence pairs with the one in Writer::run() so
+    // either that drain sees the record or this check sees the writer gone
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_writerRunning.loadRelaxed()) {
+        drainQueue();
+        return;
+    }
+
+    if (m_writerIdle.loadAcquire()) {
+        wakeWriter();
+    }
+}
+
+void Logger::wakeWriter()
+{
+    QMutexLocker locker(&m_wakeMutex);
+    m_wakeCondition.wakeOne();
+}
 
-    switch (type) {
-    case QtDebugMsg:
-        typeStr = "DEBUG";
-        break;
-    case QtInfoMsg:
-        typeStr = "INFO ";
-        break;
-    case QtWarningMsg:
-        typeStr = "WARN ";
-        break;
-    case QtCriticalMsg:
-        typeStr = "ERROR";
-        break;
-    case QtFatalMsg:
-        typeStr = "FATAL";
-        break;
+QString Logger::messageText(const Record& record)
+{
+    if (record.formatId == 0) {
+        return record.message;
     }
+    return BinaryLog::render(QString::fromUtf8(BinaryLog::formatString(record.formatId)),
+                             BinaryLog::decodeArgs(record.args));
+}
+
+bool Logger::drainQueue()
+{
+    Record record;
+    bool drained = false;
+
+    while (true) {
+        QMutexLocker locker(&m_mutex);
+        if (!m_binaryMode && m_logFile.isOpen() && m_logFile.size() > m_maxFileSize) {
+            rotateLogFiles();
+        }
+
+        int count = 0;
+        while (count < WriteBatchSize && m_queue.tryPop(record)) {
+            writeRecord(record);
+            ++count;
+        }
 
-    QString category = context.category ? QString(context.category) : "default";
-    QString logMessage =
-        QString("[%1] [%2] [%3] %4").arg(timestamp, typeStr, category, msg);
+        // Report drops in the log itself once the writer catches up and has a file
+        quint64 dropped = m_dropped.loadRelaxed();
+        if (dropped != m_reportedDropped && (!m_binaryMode || m_binaryFile.isOpen())) {
+            Record notice;
+            notice.timestampUs = BinaryLog::currentTimestampUs();
+            notice.type = QtWarningMsg;
+            qstrncpy(notice.category, "logger", sizeof(notice.category));
+            notice.message = QString("%1 log records dropped, %2 in total")
+                                 .arg(dropped - m_reportedDropped)
+                                 .arg(dropped);
+            writeRecord(notice);
+            m_reportedDropped = dropped;
+            ++count;
+        }
 
-    // Write to file
-    if (logger.m_logFile.isOpen()) {
-        QTextStream stream(&logger.m_logFile);
-        stream << logMessage << "\n";
-        stream.flush();
+        if (count == 0) {
+            return drained;
+        }
+
+        // One flush per batch; binary records are already in the mapping. Consuming stays
+        // under the lock: once the writer has stopped, loggers drain the ring too.
+        m_logFile.flush();
+        m_queue.markConsumed();
+        locker.unlock();
+        drained = true;
+    }
+}
+
+void Logger::writeRecord(const Record& record)
+{
+    if (m_binaryMode) {
+        writeBinaryRecord(record);
+    } else if (m_logFile.isOpen()) {
+        m_logFile.write(BinaryLog::formatLine(record.timestampUs, record.type, record.category,
+                                              messageText(record)));
     }
 
     // Also output to console in debug builds
 #ifdef QT_DEBUG
-    fprintf(stderr, "%s\n", logMessage.toLocal8Bit().constData());
+    QByteArray line = BinaryLog::formatLine(record.timestampUs, record.type, record.category,
+                                            messageText(record));
+    fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stderr);
 #endif
+}
 
-    if (type == QtFatalMsg) {
-        abort();
+void Logger::writeBinaryRecord(const Record& record)
+{
+    // No file (the last open failed): drop the record, trying to open again once the
+    // backoff has passed rather than on every record
+    if (!m_binaryFile.isOpen()) {
+        if (BinaryLog::currentTimestampUs() < m_binaryRetryAtUs) {
+            m_dropped.fetchAndAddRelaxed(1);
+            return;
+        }
+        openBinaryFile();
+        if (!m_binaryFile.isOpen()) {
+            m_dropped.fetchAndAddRelaxed(1);
+            return;
+        }
+    }
+
+    QByteArray encoded = encodeBinaryRecord(record);
+    if (m_binaryFile.append(encoded)) {
+        return;
+    }
+
+    // Segment full: start a new file, which needs its own definitions
+    rotateLogFiles();
+    if (!m_binaryFile.isOpen()) {
+        m_dropped.fetchAndAddRelaxed(1);
+        return;
+    }
+    encoded = encodeBinaryRecord(record);
+    if (!m_binaryFile.append(encoded)) {
+        m_dropped.fetchAndAddRelaxed(1);
     }
 }
 
+QByteArray Logger::encodeBinaryRecord(const Record& record)
+{
+    QByteArray out;
+
+    QByteArray categoryName(record.category);
+    auto category = m_categoryIds.constFind(categoryName);
+    if (category == m_categoryIds.constEnd()) {
+        BinaryLog::RecordHeader definition;
+        definition.kind = BinaryLog::RecordKind::CategoryDef;
+        definition.category = static_cast<quint16>(m_categoryIds.size() + 1);
+        BinaryLog::appendRecord(out, definition, categoryName);
+        category = m_categoryIds.insert(categoryName, definition.category);
+    }
+
+    if (record.formatId != 0 && !m_definedFormats.contains(record.formatId)) {
+        BinaryLog::RecordHeader definition;
+        definition.kind = BinaryLog::RecordKind::FormatDef;
+        definition.format = record.formatId;
+        BinaryLog::appendRecord(out, definition, BinaryLog::formatString(record.formatId));
+        m_definedFormats.insert(record.formatId);
+    }
+
+    BinaryLog::RecordHeader header;
+    header.level = static_cast<quint8>(record.type);
+    header.category = category.value();
+    header.timestampUs = record.timestampUs;
+    if (record.formatId != 0) {
+        header.kind = BinaryLog::RecordKind::Message;
+        header.format = record.formatId;
+        BinaryLog::appendRecord(out, header, record.args);
+    } else {
+        header.kind = BinaryLog::RecordKind::Text;
+        BinaryLog::appendRecord(out, header, record.message.toUtf8());
+    }
+    return out;
+}
+
+void Logger::openBinaryFile()
+{
+    m_categoryIds.clear();
+    m_definedFormats.clear();
+    if (m_binaryFile.open(getLogFileName(0), BinaryLog::fileHeader(), m_maxFileSize)) {
+        m_binaryRetryDelayMs = 0;
+        return;
+    }
+
+    // Back off before the next attempt, doubling up to a limit while it keeps failing
+    if (m_binaryRetryDelayMs == 0) {
+        fprintf(stderr, "Cannot open binary log %s: %s\n", qPrintable(getLogFileName(0)),
+                qPrintable(m_binaryFile.errorString()));
+    }
+    m_binaryRetryDelayMs = qBound(MinReopenDelayMs, m_binaryRetryDelayMs * 2, MaxReopenDelayMs);
+    m_binaryRetryAtUs = BinaryLog::currentTimestampUs() + quint64(m_binaryRetryDelayMs) * 1000;
+}
+
+void Logger::Writer::run()
+{
+    Logger* logger = m_logger;
+    while (true) {
+        bool stopping = logger->m_stopRequested.loadAcquire() != 0;
+        if (logger->drainQueue()) {
+            continue;
+        }
+        if (stopping) {
+            break;
+        }
+
+        // Nothing queued: sleep until a logger wakes us. The queue is re-checked after
+        // advertising idleness so a record pushed in between is not left waiting.
+        QMutexLocker locker(&logger->m_wakeMutex);
+        logger->m_writerIdle.storeRelease(1);
+        if (logger->m_queue.pushed() == logger->m_queue.consumed() &&
+            !logger->m_stopRequested.loadAcquire()) {
+            logger->m_wakeCondition.wait(&logger->m_wakeMutex, WriterIdleWaitMs);
+        }
+        logger->m_writerIdle.storeRelease(0);
+    }
+
+    // Anything logged from here on is written synchronously; a record pushed by a logger
+    // that still saw the writer running is drained by this call or by that logger
+    logger->m_writerRunning.storeRelease(0);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    logger->drainQueue();
+}
+
 void Logger::rotateLogFiles()
 {
     m_logFile.close();
+    m_binaryFile.close();
 
     // Remove oldest log file
     QString oldestFile = getLogFileName(m_maxFiles - 1);
@@ -147,14 +438,18 @@ void Logger::rotateLogFiles()
         QFile::rename(oldName, newName);
     }
 
+    if (m_binaryMode) {
+        openBinaryFile();
+        return;
+    }
+
     // Open new log file
     m_logFile.setFileName(getLogFileName(0));
     m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
 
-    QTextStream stream(&m_logFile);
-    stream << "\n=== Log rotated at " << QDateTime::currentDateTime().toString(Qt::ISODate)
-           << " ===\n";
-    stream.flush();
+    QByteArray banner = "\n=== Log rotated at " +
+                        QDateTime::currentDateTime().toString(Qt::ISODate).toUtf8() + " ===\n";
+    m_logFile.write(banner);
 }
 
 QString Logger::getLogFileName(int index) const
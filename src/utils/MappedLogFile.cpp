@@ -0,0 +1,67 @@
+#include "MappedLogFile.h"
+#include <cstring>
+
+MappedLogFile::MappedLogFile() : m_data(nullptr), m_capacity(0), m_used(0)
+{
+}
+
+MappedLogFile::~MappedLogFile()
+{
+    close();
+}
+
+bool MappedLogFile::open(const QString& path, const QByteArray& header, qint64 segmentSize)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        return false;
+    }
+
+    // Unwritten space reads as zeros, which the decoder takes as the end of data
+    if (segmentSize < header.size() || !m_file.resize(segmentSize)) {
+        m_file.close();
+        return false;
+    }
+
+    m_data = m_file.map(0, segmentSize);
+    if (!m_data) {
+        m_file.close();
+        return false;
+    }
+
+    m_capacity = segmentSize;
+    m_used = 0;
+    append(header);
+    return true;
+}
+
+void MappedLogFile::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    if (m_data) {
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+
+    // Drop the unused tail so finished segments take only the space they need
+    m_file.resize(m_used);
+    m_file.close();
+    m_capacity = 0;
+    m_used = 0;
+}
+
+bool MappedLogFile::append(const QByteArray& data)
+{
+    if (!m_data || m_used + data.size() > m_capacity) {
+        return false;
+    }
+
+    std::memcpy(m_data + m_used, data.constData(), static_cast<size_t>(data.size()));
+    m_used += data.size();
+    return true;
+}
@@ -1,5 +1,7 @@
 #include "TerminalBuffer.h"
 #include "ANSIParser.h"
+#include "ControlScan.h"
+#include "TerminalEmulator.h"
 #include "SSHConnection.h"
 #include "SSHChannel.h"
 #include "ProfileStorage.h"
@@ -20,6 +22,7 @@ private slots:
     void benchmarkTerminalBufferScrollback();
     void benchmarkANSIParserSimple();
     void benchmarkANSIParserComplex();
+    void benchmarkEmulatorLargeOutput();
     void benchmarkProfileSerialization();
     void benchmarkConnectionSetup();
     void benchmarkChannelThroughput();
@@ -165,6 +168,24 @@ void TestPerformance::benchmarkANSIParserComplex()
     qInfo() << "  Throughput:" << (numSequences * 1000.0 / elapsed) << "sequences/sec";
 }
 
+void TestPerformance::benchmarkEmulatorLargeOutput()
+{
+    const int numLines = 100000;
+    QString largeText = generateLargeOutput(numLines, 80);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QBENCHMARK {
+        TerminalEmulator emulator(24, 80);
+        emulator.processData(largeText);
+    }
+
+    qint64 elapsed = timer.elapsed();
+    qInfo() << "TerminalEmulator (plain," << Escape::controlScanImplementation() << "scan):"
+            << numLines << "lines in" << elapsed << "ms";
+}
+
 void TestPerformance::benchmarkProfileSerialization()
 {
     const int numProfiles = 100;
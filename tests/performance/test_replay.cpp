@@ -0,0 +1,290 @@
+#include "AllocTracker.h"
+#include "TerminalEmulator.h"
+#include "TerminalView.h"
+#include <QTest>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifndef SSH_CLIENT_ALLOC_TRACKING
+// Count heap allocations made anywhere in this binary so each replay can report
+// how many allocations the pipeline performs per megabyte of terminal output. Builds
+// with ENABLE_ALLOC_TRACKING use the per-subsystem counters in terminal-core instead.
+namespace {
+std::atomic<quint64> g_allocationCount{0};
+std::atomic<quint64> g_allocatedBytes{0};
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+namespace {
+
+// Captures are recorded at this size by scripts/record_capture.sh
+constexpr int CaptureRows = 40;
+constexpr int CaptureColumns = 120;
+
+// Bytes handed to the emulator per call, matching one SSH/PTY read
+constexpr int ReadChunkSize = 4096;
+
+// Bytes consumed between two paints when replaying through the view
+constexpr int FrameChunkSize = 16384;
+
+struct AllocationSnapshot {
+    quint64 count;
+    quint64 bytes;
+    AllocTracker::Counts subsystems[AllocTracker::SubsystemCount];
+
+    static AllocationSnapshot now()
+    {
+        AllocationSnapshot snapshot = {};
+#ifdef SSH_CLIENT_ALLOC_TRACKING
+        for (int i = 0; i < AllocTracker::SubsystemCount; ++i) {
+            snapshot.subsystems[i] = AllocTracker::counts(static_cast<AllocTracker::Subsystem>(i));
+            snapshot.count += snapshot.subsystems[i].allocations;
+            snapshot.bytes += snapshot.subsystems[i].bytes;
+        }
+#else
+        snapshot.count = g_allocationCount.load(std::memory_order_relaxed);
+        snapshot.bytes = g_allocatedBytes.load(std::memory_order_relaxed);
+#endif
+        return snapshot;
+    }
+};
+
+// Per-subsystem breakdown between two snapshots (allocation tracking builds only)
+void logSubsystemAllocations(const AllocationSnapshot& before, const AllocationSnapshot& after)
+{
+    if (!AllocTracker::isCompiledIn()) {
+        return;
+    }
+    for (int i = 0; i < AllocTracker::SubsystemCount; ++i) {
+        quint64 count = after.subsystems[i].allocations - before.subsystems[i].allocations;
+        quint64 bytes = after.subsystems[i].bytes - before.subsystems[i].bytes;
+        if (count > 0) {
+            auto subsystem = static_cast<AllocTracker::Subsystem>(i);
+            qInfo() << "    " << AllocTracker::subsystemName(subsystem) << ":" << count << "("
+                    << (bytes / 1024) << "KB)";
+        }
+    }
+}
+
+// size bytes of data from offset, or fewer at the end, without copying them; slicing
+// with mid() would add a copy and an allocation per read to what is being measured
+QByteArray chunkOf(const QByteArray& data, int offset, int size)
+{
+    return QByteArray::fromRawData(data.constData() + offset,
+                                   qMin(size, static_cast<int>(data.size()) - offset));
+}
+
+double percentile(QVector<qint64> samples, double fraction)
+{
+    if (samples.isEmpty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    int index = qBound(0, static_cast<int>(fraction * (samples.size() - 1) + 0.5),
+                       samples.size() - 1);
+    return samples[index] / 1e6;
+}
+
+} // namespace
+
+class TestReplay : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // Replay benchmarks over the capture corpus
+    void replayEmulator_data();
+    void replayEmulator();
+    void replayView_data();
+    void replayView();
+
+private:
+    void addCaptureRows();
+    QByteArray loadCapture(const QString& path);
+
+    QDir m_corpusDir;
+};
+
+void TestReplay::initTestCase()
+{
+    // REPLAY_CORPUS_DIR in the environment points the harness at other captures
+    QString corpus = qEnvironmentVariable("REPLAY_CORPUS_DIR");
+#ifdef REPLAY_CORPUS_DIR
+    if (corpus.isEmpty()) {
+        corpus = QStringLiteral(REPLAY_CORPUS_DIR);
+    }
+#endif
+    m_corpusDir = QDir(corpus);
+
+    if (corpus.isEmpty() || m_corpusDir.entryList({"*.cap"}, QDir::Files).isEmpty()) {
+        QSKIP("No replay captures found; set REPLAY_CORPUS_DIR");
+    }
+
+    qInfo() << "Replaying captures from" << m_corpusDir.absolutePath();
+}
+
+void TestReplay::addCaptureRows()
+{
+    QTest::addColumn<QString>("path");
+
+    const QStringList captures = m_corpusDir.entryList({"*.cap"}, QDir::Files, QDir::Name);
+    for (const QString& name : captures) {
+        QTest::newRow(qPrintable(QFileInfo(name).completeBaseName()))
+            << m_corpusDir.absoluteFilePath(name);
+    }
+}
+
+QByteArray TestReplay::loadCapture(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+void TestReplay::replayEmulator_data()
+{
+    addCaptureRows();
+}
+
+void TestReplay::replayEmulator()
+{
+    QFETCH(QString, path);
+
+    const QByteArray capture = loadCapture(path);
+    QVERIFY2(!capture.isEmpty(), qPrintable("Cannot read " + path));
+
+    // Best of a few passes to keep scheduler noise out of the throughput figure
+    const int passes = 3;
+    qint64 bestNs = 0;
+    AllocationSnapshot passStart = {};
+    AllocationSnapshot passEnd = {};
+    quint64 sequences = 0;
+
+    for (int pass = 0; pass < passes; ++pass) {
+        TerminalEmulator emulator(CaptureRows, CaptureColumns);
+
+        AllocationSnapshot before = AllocationSnapshot::now();
+        QElapsedTimer timer;
+        timer.start();
+        for (int offset = 0; offset < capture.size(); offset += ReadChunkSize) {
+            emulator.processData(chunkOf(capture, offset, ReadChunkSize));
+        }
+        qint64 elapsed = qMax<qint64>(timer.nsecsElapsed(), 1);
+        AllocationSnapshot after = AllocationSnapshot::now();
+
+        QVERIFY(emulator.screen().cursorRow() < CaptureRows);
+
+        if (pass == 0 || elapsed < bestNs) {
+            bestNs = elapsed;
+        }
+        passStart = before;
+        passEnd = after;
+        sequences = emulator.sequenceCount();
+    }
+
+    const double megabytes = capture.size() / (1024.0 * 1024.0);
+    qInfo() << "Emulator replay" << QTest::currentDataTag() << ":" << capture.size() << "bytes,"
+            << sequences << "sequences";
+    qInfo() << "  Throughput:" << (megabytes / (bestNs / 1e9)) << "MB/s";
+    const quint64 allocationCount = passEnd.count - passStart.count;
+    qInfo() << "  Allocations:" << allocationCount << "(" << (allocationCount / megabytes)
+            << "per MB," << ((passEnd.bytes - passStart.bytes) / 1024) << "KB total)";
+    logSubsystemAllocations(passStart, passEnd);
+}
+
+void TestReplay::replayView_data()
+{
+    addCaptureRows();
+}
+
+void TestReplay::replayView()
+{
+    QFETCH(QString, path);
+
+    const QByteArray capture = loadCapture(path);
+    QVERIFY2(!capture.isEmpty(), qPrintable("Cannot read " + path));
+
+    TerminalView view;
+    view.setAttribute(Qt::WA_DontShowOnScreen);
+    view.resize(1280, 800);
+
+    // The first render delivers the pending resize event; pin the grid afterwards
+    QImage frame(view.size(), QImage::Format_RGB32);
+    view.render(&frame);
+    view.setDimensions(CaptureRows, CaptureColumns);
+
+    // One frame = consume a batch of reads, then paint the whole view
+    QVector<qint64> frameTimes;
+    QVector<qint64> paintTimes;
+    AllocationSnapshot before = AllocationSnapshot::now();
+    QElapsedTimer total;
+    total.start();
+
+    for (int offset = 0; offset < capture.size(); offset += FrameChunkSize) {
+        QElapsedTimer timer;
+        timer.start();
+
+        const QByteArray batch = chunkOf(capture, offset, FrameChunkSize);
+        for (int pos = 0; pos < batch.size(); pos += ReadChunkSize) {
+            view.displayOutput(chunkOf(batch, pos, ReadChunkSize));
+        }
+
+        qint64 processed = timer.nsecsElapsed();
+        view.render(&frame);
+        qint64 elapsed = timer.nsecsElapsed();
+
+        frameTimes.append(elapsed);
+        paintTimes.append(elapsed - processed);
+    }
+
+    qint64 totalNs = qMax<qint64>(total.nsecsElapsed(), 1);
+    AllocationSnapshot after = AllocationSnapshot::now();
+    quint64 allocationCount = after.count - before.count;
+
+    QVERIFY(!frameTimes.isEmpty());
+
+    const double megabytes = capture.size() / (1024.0 * 1024.0);
+    qInfo() << "View replay" << QTest::currentDataTag() << ":" << frameTimes.size() << "frames";
+    qInfo() << "  Throughput:" << (megabytes / (totalNs / 1e9)) << "MB/s";
+    qInfo() << "  Frame time p50/p99/max:" << percentile(frameTimes, 0.5) << "/"
+            << percentile(frameTimes, 0.99) << "/" << percentile(frameTimes, 1.0) << "ms";
+    qInfo() << "  Paint time p50/p99:" << percentile(paintTimes, 0.5) << "/"
+            << percentile(paintTimes, 0.99) << "ms";
+    qInfo() << "  Allocations:" << allocationCount << "("
+            << (allocationCount / static_cast<double>(frameTimes.size())) << "per frame)";
+    logSubsystemAllocations(before, after);
+}
+
+QTEST_MAIN(TestReplay)
+#include "test_replay.moc"
@@ -0,0 +1,281 @@
+#include "ConnectionProfile.h"
+#include "SSHAuthenticator.h"
+#include "SSHChannel.h"
+#include "SSHConnection.h"
+#include "SSHWorkerThread.h"
+#include "TestSshServer.h"
+#include <QTest>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QVector>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+constexpr int ConnectIterations = 10;
+constexpr int EchoRoundTrips = 200;
+constexpr qint64 StreamBytes = 32 * 1024 * 1024;
+
+double percentileMs(QVector<qint64> samples, double fraction)
+{
+    if (samples.isEmpty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    int index = qBound(0, static_cast<int>(fraction * (samples.size() - 1) + 0.5),
+                       samples.size() - 1);
+    return samples[index] / 1e6;
+}
+
+} // namespace
+
+// End-to-end SSH benchmarks against TestSshServer, so connect, auth, bulk
+// throughput and echo latency can be measured without a real server
+class TestSshThroughput : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchmarkConnectAndAuth();
+    void benchmarkChannelThroughput();
+    void benchmarkWorkerThroughput();
+    void benchmarkEchoLatency_data();
+    void benchmarkEchoLatency();
+
+private:
+    std::unique_ptr<TestSshServer> startServer(const TestSshServer::Options& options);
+    bool connectClient(SSHConnection& connection, SSHAuthenticator& authenticator, quint16 port);
+};
+
+void TestSshThroughput::initTestCase()
+{
+    qInfo() << "Starting SSH benchmarks against the in-process server";
+}
+
+std::unique_ptr<TestSshServer> TestSshThroughput::startServer(const TestSshServer::Options& options)
+{
+    auto server = std::make_unique<TestSshServer>(options);
+    if (!server->listen()) {
+        qWarning() << "Test server failed to start:" << server->lastError();
+        return nullptr;
+    }
+    return server;
+}
+
+bool TestSshThroughput::connectClient(SSHConnection& connection, SSHAuthenticator& authenticator,
+                                      quint16 port)
+{
+    ConnectionProfile profile("bench", "127.0.0.1", port, "bench");
+    connection.setProfile(profile);
+    connection.setAuthenticator(&authenticator);
+    connection.connectToHost();
+    return connection.waitForConnected(10000);
+}
+
+void TestSshThroughput::benchmarkConnectAndAuth()
+{
+    auto server = startServer(TestSshServer::Options());
+    QVERIFY(server);
+
+    // Split handshake and authentication with raw libssh calls
+    QVector<qint64> connectTimes;
+    QVector<qint64> authTimes;
+    for (int i = 0; i < ConnectIterations; ++i) {
+        ssh_session session = ssh_new();
+        unsigned int port = server->port();
+        ssh_options_set(session, SSH_OPTIONS_HOST, "127.0.0.1");
+        ssh_options_set(session, SSH_OPTIONS_PORT, &port);
+        ssh_options_set(session, SSH_OPTIONS_USER, "bench");
+
+        QElapsedTimer timer;
+        timer.start();
+        QCOMPARE(ssh_connect(session), SSH_OK);
+        connectTimes.append(timer.nsecsElapsed());
+
+        timer.restart();
+        QCOMPARE(ssh_userauth_password(session, nullptr, "bench"), int(SSH_AUTH_SUCCESS));
+        authTimes.append(timer.nsecsElapsed());
+
+        ssh_disconnect(session);
+        ssh_free(session);
+    }
+
+    // The same work through SSHConnection, as the application does it
+    QVector<qint64> totalTimes;
+    for (int i = 0; i < ConnectIterations; ++i) {
+        SSHConnection connection;
+        SSHAuthenticator authenticator;
+        authenticator.setPassword("bench");
+
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY2(connectClient(connection, authenticator, server->port()),
+                 qPrintable(connection.lastError()));
+        totalTimes.append(timer.nsecsElapsed());
+        connection.disconnect();
+    }
+
+    qInfo() << "Connect (key exchange) p50/max:" << percentileMs(connectTimes, 0.5) << "/"
+            << percentileMs(connectTimes, 1.0) << "ms";
+    qInfo() << "Password auth p50/max:" << percentileMs(authTimes, 0.5) << "/"
+            << percentileMs(authTimes, 1.0) << "ms";
+    qInfo() << "SSHConnection connect+auth p50/max:" << percentileMs(totalTimes, 0.5) << "/"
+            << percentileMs(totalTimes, 1.0) << "ms";
+}
+
+void TestSshThroughput::benchmarkChannelThroughput()
+{
+    TestSshServer::Options options;
+    options.mode = TestSshServer::Mode::Stream;
+    options.streamBytes = StreamBytes;
+    auto server = startServer(options);
+    QVERIFY(server);
+
+    SSHConnection connection;
+    SSHAuthenticator authenticator;
+    authenticator.setPassword("bench");
+    QVERIFY2(connectClient(connection, authenticator, server->port()),
+             qPrintable(connection.lastError()));
+
+    SSHChannel channel(connection.session());
+    QVERIFY(channel.open());
+    QVERIFY(channel.requestPty(24, 80));
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(channel.requestShell());
+
+    qint64 received = 0;
+    while (received < StreamBytes && !channel.isEof()) {
+        received += channel.readBytes(65536, 1000).size();
+    }
+    qint64 elapsed = qMax<qint64>(timer.nsecsElapsed(), 1);
+
+    QCOMPARE(received, StreamBytes);
+    qInfo() << "SSHChannel bulk read:" << (received / (1024.0 * 1024.0)) / (elapsed / 1e9)
+            << "MB/s";
+
+    channel.close();
+    connection.disconnect();
+}
+
+void TestSshThroughput::benchmarkWorkerThroughput()
+{
+    TestSshServer::Options options;
+    options.mode = TestSshServer::Mode::Stream;
+    options.streamBytes = StreamBytes;
+    auto server = startServer(options);
+    QVERIFY(server);
+
+    SSHConnection connection;
+    SSHAuthenticator authenticator;
+    authenticator.setPassword("bench");
+    QVERIFY2(connectClient(connection, authenticator, server->port()),
+             qPrintable(connection.lastError()));
+
+    // Consume and acknowledge on the main thread like MainWindow does
+    SSHWorkerThread worker(&connection);
+    qint64 received = 0;
+    connect(&worker, &SSHWorkerThread::dataReceived, this,
+            [&worker, &received](const QByteArray& data) {
+                received += data.size();
+                worker.acknowledgeData(data.size());
+            });
+
+    QElapsedTimer timer;
+    timer.start();
+    worker.start();
+
+    // Count until the last queued delivery has been handled on this thread
+    QTRY_COMPARE_WITH_TIMEOUT(received, StreamBytes, 60000);
+    qint64 elapsed = qMax<qint64>(timer.nsecsElapsed(), 1);
+
+    qInfo() << "SSHWorkerThread bulk read:" << (received / (1024.0 * 1024.0)) / (elapsed / 1e9)
+            << "MB/s," << worker.backpressureCount() << "backpressure pauses";
+
+    worker.stop();
+    worker.wait();
+    connection.disconnect();
+}
+
+void TestSshThroughput::benchmarkEchoLatency_data()
+{
+    QTest::addColumn<int>("latencyMs");
+
+    QTest::newRow("no-latency") << 0;
+    QTest::newRow("20ms") << 20;
+}
+
+void TestSshThroughput::benchmarkEchoLatency()
+{
+    QFETCH(int, latencyMs);
+
+    TestSshServer::Options options;
+    options.mode = TestSshServer::Mode::Echo;
+    options.latencyMs = latencyMs;
+    auto server = startServer(options);
+    QVERIFY(server);
+
+    SSHConnection connection;
+    SSHAuthenticator authenticator;
+    authenticator.setPassword("bench");
+    QVERIFY2(connectClient(connection, authenticator, server->port()),
+             qPrintable(connection.lastError()));
+
+    // Channel level: one keystroke out, wait for its echo
+    QVector<qint64> channelTimes;
+    {
+        SSHChannel channel(connection.session());
+        QVERIFY(channel.open());
+        QVERIFY(channel.requestShell());
+
+        for (int i = 0; i < EchoRoundTrips; ++i) {
+            QElapsedTimer timer;
+            timer.start();
+            QCOMPARE(channel.write(QByteArray("k")), 1);
+            QByteArray echoed;
+            while (echoed.isEmpty() && timer.elapsed() < 5000) {
+                echoed = channel.readBytes(16, 1000);
+            }
+            QCOMPARE(echoed, QByteArray("k"));
+            channelTimes.append(timer.nsecsElapsed());
+        }
+        channel.close();
+    }
+    connection.disconnect();
+
+    // Worker level: includes the write queue, the read loop and signal delivery
+    SSHConnection workerConnection;
+    QVERIFY2(connectClient(workerConnection, authenticator, server->port()),
+             qPrintable(workerConnection.lastError()));
+
+    SSHWorkerThread worker(&workerConnection);
+    QSignalSpy dataSpy(&worker, &SSHWorkerThread::dataReceived);
+    worker.start();
+
+    QVector<qint64> workerTimes;
+    for (int i = 0; i < EchoRoundTrips / 2; ++i) {
+        dataSpy.clear();
+        QElapsedTimer timer;
+        timer.start();
+        worker.writeData(QByteArray("k"));
+        QVERIFY(dataSpy.wait(5000));
+        workerTimes.append(timer.nsecsElapsed());
+        worker.acknowledgeData(dataSpy.first().first().toByteArray().size());
+    }
+
+    worker.stop();
+    worker.wait();
+    workerConnection.disconnect();
+
+    qInfo() << "Echo latency" << QTest::currentDataTag();
+    qInfo() << "  SSHChannel p50/p99:" << percentileMs(channelTimes, 0.5) << "/"
+            << percentileMs(channelTimes, 0.99) << "ms";
+    qInfo() << "  SSHWorkerThread p50/p99:" << percentileMs(workerTimes, 0.5) << "/"
+            << percentileMs(workerTimes, 0.99) << "ms";
+}
+
+QTEST_MAIN(TestSshThroughput)
+#include "test_ssh_throughput.moc"
@@ -0,0 +1,268 @@
+#include "TestSshServer.h"
+#include <QMutexLocker>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+namespace {
+constexpr int AcceptPollInterval = 100;
+constexpr int EchoReadTimeout = 100;
+} // namespace
+
+TestSshServer::TestSshServer(const Options& options, QObject* parent)
+    : QThread(parent), m_options(options), m_bind(nullptr), m_port(0), m_stopRequested(0),
+      m_bytesSent(0), m_bytesReceived(0), m_sessionsServed(0)
+{
+}
+
+TestSshServer::~TestSshServer()
+{
+    stop();
+    if (m_bind) {
+        ssh_bind_free(m_bind);
+    }
+}
+
+bool TestSshServer::listen()
+{
+    // A throwaway host key per server; clients under test accept any key
+    ssh_key hostKey = nullptr;
+    if (ssh_pki_generate(SSH_KEYTYPE_ED25519, 0, &hostKey) != SSH_OK) {
+        setError("Failed to generate host key");
+        return false;
+    }
+
+    m_bind = ssh_bind_new();
+    if (!m_bind) {
+        ssh_key_free(hostKey);
+        setError("Failed to create ssh_bind");
+        return false;
+    }
+
+    unsigned int port = 0;
+    ssh_bind_options_set(m_bind, SSH_BIND_OPTIONS_BINDADDR, "127.0.0.1");
+    ssh_bind_options_set(m_bind, SSH_BIND_OPTIONS_BINDPORT, &port);
+
+    // The bind takes ownership of the imported key
+    if (ssh_bind_options_set(m_bind, SSH_BIND_OPTIONS_IMPORT_KEY, hostKey) != SSH_OK) {
+        ssh_key_free(hostKey);
+        setError(QString("Failed to set host key: %1").arg(ssh_get_error(m_bind)));
+        return false;
+    }
+
+    if (ssh_bind_listen(m_bind) < 0) {
+        setError(QString("Failed to listen: %1").arg(ssh_get_error(m_bind)));
+        return false;
+    }
+
+    struct sockaddr_in address = {};
+    socklen_t length = sizeof(address);
+    if (getsockname(ssh_bind_get_fd(m_bind), reinterpret_cast<struct sockaddr*>(&address),
+                    &length) != 0) {
+        setError("Failed to query the listening port");
+        return false;
+    }
+    m_port = ntohs(address.sin_port);
+
+    m_stopRequested.storeRelaxed(0);
+    start();
+    return true;
+}
+
+void TestSshServer::stop()
+{
+    m_stopRequested.storeRelaxed(1);
+    if (isRunning()) {
+        wait();
+    }
+}
+
+QString TestSshServer::lastError() const
+{
+    QMutexLocker locker(&m_errorMutex);
+    return m_lastError;
+}
+
+void TestSshServer::setError(const QString& message)
+{
+    QMutexLocker locker(&m_errorMutex);
+    m_lastError = message;
+}
+
+void TestSshServer::run()
+{
+    const socket_t listenFd = ssh_bind_get_fd(m_bind);
+
+    // Poll so that stop() is noticed without a pending connection
+    while (!m_stopRequested.loadRelaxed()) {
+        struct pollfd pfd = {listenFd, POLLIN, 0};
+        if (::poll(&pfd, 1, AcceptPollInterval) <= 0) {
+            continue;
+        }
+
+        ssh_session session = ssh_new();
+        if (ssh_bind_accept(m_bind, session) != SSH_OK) {
+            setError(QString("Accept failed: %1").arg(ssh_get_error(m_bind)));
+            ssh_free(session);
+            continue;
+        }
+
+        serveSession(session);
+
+        ssh_disconnect(session);
+        ssh_free(session);
+        m_sessionsServed.fetchAndAddRelaxed(1);
+    }
+}
+
+void TestSshServer::serveSession(ssh_session session)
+{
+    if (ssh_handle_key_exchange(session) != SSH_OK) {
+        setError(QString("Key exchange failed: %1").arg(ssh_get_error(session)));
+        return;
+    }
+
+    if (!authenticate(session)) {
+        return;
+    }
+
+    ssh_channel channel = openShellChannel(session);
+    if (!channel) {
+        return;
+    }
+
+    if (m_options.mode == Mode::Stream) {
+        streamPayload(channel);
+    } else {
+        echo(channel);
+    }
+
+    if (ssh_channel_is_open(channel)) {
+        ssh_channel_send_eof(channel);
+        ssh_channel_close(channel);
+    }
+    ssh_channel_free(channel);
+}
+
+bool TestSshServer::authenticate(ssh_session session)
+{
+    const QByteArray username = m_options.username.toUtf8();
+    const QByteArray password = m_options.password.toUtf8();
+
+    while (ssh_message message = ssh_message_get(session)) {
+        if (ssh_message_type(message) == SSH_REQUEST_AUTH &&
+            ssh_message_subtype(message) == SSH_AUTH_METHOD_PASSWORD &&
+            username == ssh_message_auth_user(message) &&
+            password == ssh_message_auth_password(message)) {
+            ssh_message_auth_reply_success(message, 0);
+            ssh_message_free(message);
+            return true;
+        }
+
+        // Anything else (including the "none" probe) is told to use a password
+        ssh_message_auth_set_methods(message, SSH_AUTH_METHOD_PASSWORD);
+        ssh_message_reply_default(message);
+        ssh_message_free(message);
+    }
+
+    setError("Client went away during authentication");
+    return false;
+}
+
+ssh_channel TestSshServer::openShellChannel(ssh_session session)
+{
+    ssh_channel channel = nullptr;
+    while (!channel) {
+        ssh_message message = ssh_message_get(session);
+        if (!message) {
+            return nullptr;
+        }
+
+        if (ssh_message_type(message) == SSH_REQUEST_CHANNEL_OPEN &&
+            ssh_message_subtype(message) == SSH_CHANNEL_SESSION) {
+            channel = ssh_message_channel_request_open_reply_accept(message);
+        } else {
+            ssh_message_reply_default(message);
+        }
+        ssh_message_free(message);
+    }
+
+    // Accept PTY, environment and window-change requests until the shell starts
+    while (ssh_message message = ssh_message_get(session)) {
+        int type = ssh_message_type(message);
+        int subtype = ssh_message_subtype(message);
+
+        if (type == SSH_REQUEST_CHANNEL && subtype == SSH_CHANNEL_REQUEST_SHELL) {
+            ssh_message_channel_request_reply_success(message);
+            ssh_message_free(message);
+            return channel;
+        }
+
+        if (type == SSH_REQUEST_CHANNEL &&
+            (subtype == SSH_CHANNEL_REQUEST_PTY || subtype == SSH_CHANNEL_REQUEST_ENV ||
+             subtype == SSH_CHANNEL_REQUEST_WINDOW_CHANGE)) {
+            ssh_message_channel_request_reply_success(message);
+        } else {
+            ssh_message_reply_default(message);
+        }
+        ssh_message_free(message);
+    }
+
+    ssh_channel_free(channel);
+    return nullptr;
+}
+
+void TestSshServer::streamPayload(ssh_channel channel)
+{
+    if (m_options.latencyMs > 0) {
+        msleep(m_options.latencyMs);
+    }
+
+    // Tile the payload into one write-sized chunk
+    QByteArray chunk;
+    const QByteArray payload = m_options.payload.isEmpty() ? QByteArray(1, 'x')
+                                                           : m_options.payload;
+    chunk.reserve(m_options.chunkSize);
+    while (chunk.size() < m_options.chunkSize) {
+        chunk.append(payload.left(m_options.chunkSize - chunk.size()));
+    }
+
+    qint64 remaining = m_options.streamBytes;
+    while (remaining > 0 && !m_stopRequested.loadRelaxed()) {
+        int length = static_cast<int>(qMin<qint64>(chunk.size(), remaining));
+        int written = ssh_channel_write(channel, chunk.constData(), length);
+        if (written == SSH_ERROR) {
+            break;
+        }
+        remaining -= written;
+        m_bytesSent.fetchAndAddRelaxed(written);
+    }
+}
+
+void TestSshServer::echo(ssh_channel channel)
+{
+    QByteArray buffer(m_options.chunkSize, '\0');
+
+    while (!m_stopRequested.loadRelaxed() && ssh_channel_is_open(channel) &&
+           !ssh_channel_is_eof(channel)) {
+        int nbytes =
+            ssh_channel_read_timeout(channel, buffer.data(), buffer.size(), 0, EchoReadTimeout);
+        if (nbytes < 0) {
+            break;
+        }
+        if (nbytes == 0) {
+            continue;
+        }
+        m_bytesReceived.fetchAndAddRelaxed(nbytes);
+
+        if (m_options.latencyMs > 0) {
+            msleep(m_options.latencyMs);
+        }
+
+        if (ssh_channel_write(channel, buffer.constData(), nbytes) == SSH_ERROR) {
+            break;
+        }
+        m_bytesSent.fetchAndAddRelaxed(nbytes);
+    }
+}
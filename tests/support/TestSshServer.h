@@ -0,0 +1,76 @@
+#ifndef TESTSSHSERVER_H
+#define TESTSSHSERVER_H
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <libssh/libssh.h>
+#include <libssh/server.h>
+
+// In-process SSH server built on libssh's server API, used to benchmark
+// SSHConnection, SSHChannel and SSHWorkerThread without a real sshd. It listens on
+// 127.0.0.1 with a freshly generated host key, accepts one password, and serves
+// sessions one at a time on its own thread.
+class TestSshServer : public QThread {
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        // Send streamBytes of payload after the shell starts, then EOF and close
+        Stream,
+        // Write every received byte straight back
+        Echo
+    };
+
+    struct Options {
+        QString username = "bench";
+        QString password = "bench";
+        Mode mode = Mode::Echo;
+        QByteArray payload = QByteArray(1024, 'x');
+        qint64 streamBytes = 8 * 1024 * 1024;
+        int chunkSize = 16384;
+        // Delay applied before each echo and before the first streamed byte
+        int latencyMs = 0;
+    };
+
+    explicit TestSshServer(const Options& options = Options(), QObject* parent = nullptr);
+    ~TestSshServer();
+
+    // Generates the host key and binds an ephemeral port, then starts serving
+    bool listen();
+    void stop();
+
+    quint16 port() const { return m_port; }
+    const Options& options() const { return m_options; }
+    QString lastError() const;
+
+    // Totals across all sessions served
+    qint64 bytesSent() const { return m_bytesSent.loadRelaxed(); }
+    qint64 bytesReceived() const { return m_bytesReceived.loadRelaxed(); }
+    int sessionsServed() const { return m_sessionsServed.loadRelaxed(); }
+
+protected:
+    void run() override;
+
+private:
+    void serveSession(ssh_session session);
+    bool authenticate(ssh_session session);
+    ssh_channel openShellChannel(ssh_session session);
+    void streamPayload(ssh_channel channel);
+    void echo(ssh_channel channel);
+    void setError(const QString& message);
+
+    Options m_options;
+    ssh_bind m_bind;
+    quint16 m_port;
+    QAtomicInteger<int> m_stopRequested;
+    QAtomicInteger<qint64> m_bytesSent;
+    QAtomicInteger<qint64> m_bytesReceived;
+    QAtomicInteger<int> m_sessionsServed;
+    mutable QMutex m_errorMutex;
+    QString m_lastError;
+};
+
+#endif // TESTSSHSERVER_H
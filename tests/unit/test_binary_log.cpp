@@ -0,0 +1,242 @@
+#include "BinaryLog.h"
+#include <QtTest/QtTest>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <limits>
+
+namespace {
+
+enum class Mode { Fast = 3 };
+
+BinaryLog::RecordHeader makeHeader(BinaryLog::RecordKind kind, quint16 category,
+                                   quint32 format, quint64 timestampUs)
+{
+    BinaryLog::RecordHeader header;
+    header.kind = kind;
+    header.level = QtWarningMsg;
+    header.category = category;
+    header.format = format;
+    header.timestampUs = timestampUs;
+    return header;
+}
+
+} // namespace
+
+class TestBinaryLog : public QObject {
+    Q_OBJECT
+
+private slots:
+    // File and record layout tests
+    void testFileHeader();
+    void testRecordRoundTrip();
+    void testEndOfData();
+    void testTruncatedRecord();
+
+    // Argument and rendering tests
+    void testArgsRoundTrip();
+    void testTruncatedArgs();
+    void testRender();
+    void testFormatRegistry();
+    void testFormatLine();
+};
+
+void TestBinaryLog::testFileHeader()
+{
+    const QByteArray header = BinaryLog::fileHeader();
+    QCOMPARE(header.size(), BinaryLog::FileHeaderSize);
+    QVERIFY(BinaryLog::checkFileHeader(header.constData(), header.size()));
+    QVERIFY(!BinaryLog::checkFileHeader(header.constData(), header.size() - 1));
+
+    QByteArray badMagic = header;
+    badMagic[0] = 'X';
+    QVERIFY(!BinaryLog::checkFileHeader(badMagic.constData(), badMagic.size()));
+
+    QByteArray badVersion = header;
+    badVersion[8] = char(BinaryLog::Version + 1);
+    QVERIFY(!BinaryLog::checkFileHeader(badVersion.constData(), badVersion.size()));
+}
+
+void TestBinaryLog::testRecordRoundTrip()
+{
+    QByteArray args;
+    BinaryLog::encodeInt(args, 42);
+    const quint64 timestamp = 1700000000123456ull;
+
+    QByteArray data;
+    BinaryLog::appendRecord(data, makeHeader(BinaryLog::RecordKind::CategoryDef, 1, 0, 0),
+                            QByteArray("ssh.connection"));
+    BinaryLog::appendRecord(data, makeHeader(BinaryLog::RecordKind::FormatDef, 0, 7, 0),
+                            QByteArray("answer %1"));
+    BinaryLog::appendRecord(data, makeHeader(BinaryLog::RecordKind::Message, 1, 7, timestamp),
+                            args);
+    BinaryLog::appendRecord(data, makeHeader(BinaryLog::RecordKind::Text, 1, 0, timestamp + 1),
+                            QByteArray());
+
+    qint64 offset = 0;
+    BinaryLog::RecordHeader header;
+    QByteArray payload;
+
+    QVERIFY(BinaryLog::readRecord(data.constData(), data.size(), offset, header, payload));
+    QCOMPARE(header.kind, BinaryLog::RecordKind::CategoryDef);
+    QCOMPARE(header.category, quint16(1));
+    QCOMPARE(payload, QByteArray("ssh.connection"));
+    QCOMPARE(offset, qint64(BinaryLog::RecordHeaderSize + 14));
+
+    QVERIFY(BinaryLog::readRecord(data.constData(), data.size(), offset, header, payload));
+    QCOMPARE(header.kind, BinaryLog::RecordKind::FormatDef);
+    QCOMPARE(header.format, quint32(7));
+    QCOMPARE(payload, QByteArray("answer %1"));
+
+    QVERIFY(BinaryLog::readRecord(data.constData(), data.size(), offset, header, payload));
+    QCOMPARE(header.kind, BinaryLog::RecordKind::Message);
+    QCOMPARE(header.level, quint8(QtWarningMsg));
+    QCOMPARE(header.category, quint16(1));
+    QCOMPARE(header.format, quint32(7));
+    QCOMPARE(header.timestampUs, timestamp);
+    QCOMPARE(header.length, quint32(BinaryLog::RecordHeaderSize + args.size()));
+    QCOMPARE(BinaryLog::render(QString("answer %1"), BinaryLog::decodeArgs(payload)),
+             QString("answer 42"));
+
+    // An empty payload is a header on its own
+    QVERIFY(BinaryLog::readRecord(data.constData(), data.size(), offset, header, payload));
+    QCOMPARE(header.kind, BinaryLog::RecordKind::Text);
+    QCOMPARE(header.length, quint32(BinaryLog::RecordHeaderSize));
+    QVERIFY(payload.isEmpty());
+
+    QCOMPARE(offset, qint64(data.size()));
+    QVERIFY(!BinaryLog::readRecord(data.constData(), data.size(), offset, header, payload));
+    QCOMPARE(offset, qint64(data.size()));
+}
+
+void TestBinaryLog::testEndOfData()
+{
+    // Segments are zero-filled past the last record; a zero length ends the data
+    QByteArray data;
+    BinaryLog::appendRecord(data, makeHeader(BinaryLog::RecordKind::Text, 0, 0, 1),
+                            QByteArray("last"));
+    const qint64 end = data.size();
+    data.append(QByteArray(64, '\0'));
+
+    qint64 offset = 0;
+    BinaryLog::RecordHeader header;
+    QByteArray payload;
+    QVERIFY(BinaryLog::readRecord(data.constData(), data.size(), offset, header, payload));
+    QVERIFY(!BinaryLog::readRecord(data.constData(), data.size(), offset, header, payload));
+    QCOMPARE(offset, end);
+}
+
+void TestBinaryLog::testTruncatedRecord()
+{
+    QByteArray data;
+    BinaryLog::appendRecord(data, makeHeader(BinaryLog::RecordKind::Text, 0, 0, 1),
+                            QByteArray("first"));
+    const qint64 second = data.size();
+    BinaryLog::appendRecord(data, makeHeader(BinaryLog::RecordKind::Text, 0, 0, 2),
+                            QByteArray("second record"));
+
+    // Cut anywhere inside the second record: the first still reads, the second is refused
+    // and the offset stays at its start
+    for (qint64 size = second; size < data.size(); ++size) {
+        qint64 offset = 0;
+        BinaryLog::RecordHeader header;
+        QByteArray payload;
+        QVERIFY(BinaryLog::readRecord(data.constData(), size, offset, header, payload));
+        QCOMPARE(payload, QByteArray("first"));
+        QVERIFY2(!BinaryLog::readRecord(data.constData(), size, offset, header, payload),
+                 qPrintable(QString("size %1").arg(size)));
+        QCOMPARE(offset, second);
+    }
+
+    // A length shorter than the header itself is not a record
+    QByteArray corrupt = data;
+    corrupt[int(second)] = char(BinaryLog::RecordHeaderSize - 1);
+    corrupt[int(second) + 1] = 0;
+    qint64 offset = second;
+    BinaryLog::RecordHeader header;
+    QByteArray payload;
+    QVERIFY(!BinaryLog::readRecord(corrupt.constData(), corrupt.size(), offset, header, payload));
+}
+
+void TestBinaryLog::testArgsRoundTrip()
+{
+    const QByteArray payload = BinaryLog::encodeArgs(
+        "unused", -5, 7u, 2.5, QString("héllo %1"), "text", true, Mode::Fast,
+        std::numeric_limits<qint64>::min(), std::numeric_limits<quint64>::max(), QString());
+
+    const QStringList args = BinaryLog::decodeArgs(payload);
+    const QStringList expected = {"-5",
+                                  "7",
+                                  "2.5",
+                                  QString("héllo %1"),
+                                  "text",
+                                  "1",
+                                  "3",
+                                  "-9223372036854775808",
+                                  "18446744073709551615",
+                                  ""};
+    QCOMPARE(args, expected);
+    QVERIFY(BinaryLog::decodeArgs(QByteArray()).isEmpty());
+}
+
+void TestBinaryLog::testTruncatedArgs()
+{
+    QByteArray payload;
+    BinaryLog::encodeInt(payload, 1);
+    const int afterInt = payload.size();
+    BinaryLog::encodeString(payload, QByteArray("abc"));
+
+    // Only arguments that are complete are decoded
+    QCOMPARE(BinaryLog::decodeArgs(payload), QStringList({"1", "abc"}));
+    for (int size = afterInt; size < payload.size(); ++size) {
+        QCOMPARE(BinaryLog::decodeArgs(payload.left(size)), QStringList({"1"}));
+    }
+    for (int size = 1; size < afterInt; ++size) {
+        QVERIFY(BinaryLog::decodeArgs(payload.left(size)).isEmpty());
+    }
+}
+
+void TestBinaryLog::testRender()
+{
+    const QStringList args = {"a", "b"};
+    QCOMPARE(BinaryLog::render("%1 and %2", args), QString("a and b"));
+    QCOMPARE(BinaryLog::render("%2%1%2", args), QString("bab"));
+    // Unmatched placeholders and stray percent signs are left as written
+    QCOMPARE(BinaryLog::render("%3 %0 100% %", args), QString("%3 %0 100% %"));
+    // Substitution is one pass: a placeholder inside an argument stays literal
+    QCOMPARE(BinaryLog::render("%1 %2", {"%2", "x"}), QString("%2 x"));
+
+    // Two-digit placeholders
+    QStringList many;
+    for (int i = 1; i <= 12; ++i) {
+        many << QString::number(i * 10);
+    }
+    QCOMPARE(BinaryLog::render("%12 %10 %1", many), QString("120 100 10"));
+    QCOMPARE(BinaryLog::render("%13", many), QString("%13"));
+}
+
+void TestBinaryLog::testFormatRegistry()
+{
+    const quint32 first = BinaryLog::registerFormatString("connected to %1");
+    const quint32 second = BinaryLog::registerFormat("%1 bytes in %2 ms", 10, 2.5);
+    QVERIFY(first >= 1);
+    QCOMPARE(second, first + 1);
+    QCOMPARE(BinaryLog::formatString(first), QByteArray("connected to %1"));
+    QCOMPARE(BinaryLog::formatString(second), QByteArray("%1 bytes in %2 ms"));
+    QVERIFY(BinaryLog::formatString(0).isEmpty());
+    QVERIFY(BinaryLog::formatString(second + 1).isEmpty());
+}
+
+void TestBinaryLog::testFormatLine()
+{
+    // The timestamp is local time; check the layout around it
+    const QByteArray line =
+        BinaryLog::formatLine(1700000000123456ull, QtWarningMsg, "ssh.auth", "denied");
+    QVERIFY(line.startsWith('['));
+    QVERIFY(line.endsWith("] [WARN ] [ssh.auth] denied\n"));
+    QCOMPARE(line.indexOf(']'), 24);
+    QVERIFY(line.contains(".123]"));
+}
+
+QTEST_MAIN(TestBinaryLog)
+#include "test_binary_log.moc"
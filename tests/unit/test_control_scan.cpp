@@ -0,0 +1,116 @@
+#include "ControlScan.h"
+#include <QtTest/QtTest>
+#include <QString>
+#include <QVector>
+
+namespace {
+
+// Long enough for two AVX2 blocks of bytes plus a scalar tail, at every alignment
+constexpr int MaxLength = 70;
+constexpr int MaxOffset = 32;
+
+// Values around the edges of the control range; the ones above 0xff have a low byte
+// that would be a control if the scanner only looked at one byte of a UTF-16 unit
+const QVector<uint> Printable16 = {0x20, 0x41, 0x7e, 0x80, 0xff, 0x011f, 0xff1f, 0xff7f, 0x1b20};
+const QVector<uint> Probes16 = {0x00, 0x1b, 0x1f, 0x7f, 0x20, 0x80, 0x011f, 0xff1f};
+const QVector<uint> Printable8 = {0x20, 0x41, 0x7e, 0x80, 0x9f, 0xff};
+const QVector<uint> Probes8 = {0x00, 0x1b, 0x1f, 0x7f, 0x20, 0x80, 0xff};
+
+// Runs scan over every length and start offset with each probe value at every position
+// (and nowhere), against a background of printable values. Returns the first case
+// where it disagrees with findControlScalar(), or an empty string.
+template <typename CharT>
+QString firstMismatch(const CharT* (*scan)(const CharT*, const CharT*),
+                      const QVector<uint>& printable, const QVector<uint>& probes)
+{
+    CharT buffer[MaxOffset + MaxLength + 1];
+    for (int offset = 0; offset < MaxOffset; ++offset) {
+        for (int length = 0; length <= MaxLength; ++length) {
+            for (uint probe : probes) {
+                for (int at = -1; at < length; ++at) {
+                    for (int i = 0; i < MaxOffset + MaxLength + 1; ++i) {
+                        buffer[i] = CharT(printable[i % printable.size()]);
+                    }
+                    // A control just past the end must not be reported
+                    buffer[offset + length] = CharT(0x1b);
+                    if (at >= 0) {
+                        buffer[offset + at] = CharT(probe);
+                    }
+
+                    const CharT* begin = buffer + offset;
+                    const CharT* end = begin + length;
+                    const CharT* expected = Escape::findControlScalar(begin, end);
+                    const CharT* found = scan(begin, end);
+                    if (found != expected) {
+                        return QString("offset %1 length %2 probe 0x%3 at %4: found %5, "
+                                       "expected %6")
+                            .arg(offset)
+                            .arg(length)
+                            .arg(probe, 0, 16)
+                            .arg(at)
+                            .arg(int(found - begin))
+                            .arg(int(expected - begin));
+                    }
+                }
+            }
+        }
+    }
+    return QString();
+}
+
+} // namespace
+
+class TestControlScan : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testScalar();
+    void testImplementationsListed();
+    void testImplementationsAgree16();
+    void testImplementationsAgree8();
+};
+
+void TestControlScan::testScalar()
+{
+    const char16_t text[] = {u'a', 0x011f, 0xff1f, 0x80, 0x7f, u'b', 0x1f};
+    QCOMPARE(Escape::findControlScalar(text, text + 7), text + 4);
+    QCOMPARE(Escape::findControlScalar(text, text + 4), text + 4);
+    QCOMPARE(Escape::findControlScalar(text + 5, text + 7), text + 6);
+    QCOMPARE(Escape::findControlScalar(text, text), text);
+
+    const char bytes[] = "ab\x80\xff \x1f";
+    QCOMPARE(Escape::findControlScalar(bytes, bytes + 6), bytes + 5);
+    QCOMPARE(Escape::findControlScalar(bytes, bytes + 5), bytes + 5);
+}
+
+void TestControlScan::testImplementationsListed()
+{
+    const QVector<Escape::ControlScanner> scanners = Escape::controlScanImplementations();
+    QVERIFY(!scanners.isEmpty());
+    QCOMPARE(QString(scanners.first().name), QString(Escape::controlScanImplementation()));
+    QCOMPARE(QString(scanners.last().name), QString("scalar"));
+}
+
+void TestControlScan::testImplementationsAgree16()
+{
+    for (const Escape::ControlScanner& scanner : Escape::controlScanImplementations()) {
+        const QString mismatch = firstMismatch(scanner.scan16, Printable16, Probes16);
+        QVERIFY2(mismatch.isEmpty(), qPrintable(QString(scanner.name) + ": " + mismatch));
+    }
+
+    // The dispatched entry point, through QChar
+    const QString text = QString("abc") + QChar(0x011f) + QString("def\x1bghi");
+    const QChar* found = Escape::findControl(text.constData(), text.constData() + text.size());
+    QCOMPARE(int(found - text.constData()), 7);
+}
+
+void TestControlScan::testImplementationsAgree8()
+{
+    for (const Escape::ControlScanner& scanner : Escape::controlScanImplementations()) {
+        const QString mismatch = firstMismatch(scanner.scan8, Printable8, Probes8);
+        QVERIFY2(mismatch.isEmpty(), qPrintable(QString(scanner.name) + ": " + mismatch));
+    }
+}
+
+QTEST_MAIN(TestControlScan)
+#include "test_control_scan.moc"
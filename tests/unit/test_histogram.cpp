@@ -0,0 +1,182 @@
+#include "Histogram.h"
+#include <QtTest/QtTest>
+
+class TestHistogram : public QObject {
+    Q_OBJECT
+
+private slots:
+    // Bucket maths tests
+    void testSmallValuesExact();
+    void testBucketEdges();
+    void testBucketPrecision();
+    void testOverflowBucket();
+
+    // Recording tests
+    void testEmpty();
+    void testUniformDistribution();
+    void testConstantDistribution();
+    void testBimodalDistribution();
+    void testPercentileClamped();
+    void testReset();
+};
+
+void TestHistogram::testSmallValuesExact()
+{
+    // Below 32 every value has a bucket of its own
+    for (quint64 value = 0; value < quint64(Histogram::SubBucketCount); ++value) {
+        QCOMPARE(Histogram::bucketIndex(value), int(value));
+        QCOMPARE(Histogram::bucketUpperBound(int(value)), value);
+    }
+    QCOMPARE(Histogram::bucketIndex(32), 32);
+    QCOMPARE(Histogram::bucketIndex(63), 63);
+    QCOMPARE(Histogram::bucketIndex(64), 64);
+    QCOMPARE(Histogram::bucketIndex(65), 64);
+    QCOMPARE(Histogram::bucketUpperBound(64), quint64(65));
+}
+
+void TestHistogram::testBucketEdges()
+{
+    // Buckets tile the range: each starts one past the end of the previous one and both
+    // of its edges map back to it
+    for (int index = 1; index < Histogram::BucketCount; ++index) {
+        const quint64 lower = Histogram::bucketUpperBound(index - 1) + 1;
+        const quint64 upper = Histogram::bucketUpperBound(index);
+        QVERIFY2(lower <= upper, qPrintable(QString("bucket %1").arg(index)));
+        QCOMPARE(Histogram::bucketIndex(lower), index);
+        QCOMPARE(Histogram::bucketIndex(upper), index);
+    }
+
+    // Each power of two starts a new magnitude at sub-bucket 0
+    for (int magnitude = 1; magnitude < Histogram::MagnitudeCount; ++magnitude) {
+        const quint64 first = quint64(Histogram::SubBucketCount) << (magnitude - 1);
+        QCOMPARE(Histogram::bucketIndex(first), magnitude * Histogram::SubBucketCount);
+        QCOMPARE(Histogram::bucketIndex(first - 1), magnitude * Histogram::SubBucketCount - 1);
+    }
+}
+
+void TestHistogram::testBucketPrecision()
+{
+    // A bucket is never wider than 1/32 of the values in it
+    for (int index = Histogram::SubBucketCount; index < Histogram::BucketCount; ++index) {
+        const quint64 lower = Histogram::bucketUpperBound(index - 1) + 1;
+        const quint64 width = Histogram::bucketUpperBound(index) - lower + 1;
+        QVERIFY2(width * Histogram::SubBucketCount <= lower,
+                 qPrintable(QString("bucket %1").arg(index)));
+    }
+}
+
+void TestHistogram::testOverflowBucket()
+{
+    // Values past the last magnitude share the last bucket
+    const quint64 last = Histogram::bucketUpperBound(Histogram::BucketCount - 1);
+    QCOMPARE(Histogram::bucketIndex(last + 1), Histogram::BucketCount - 1);
+    QCOMPARE(Histogram::bucketIndex(quint64(1) << 60), Histogram::BucketCount - 1);
+    QCOMPARE(Histogram::bucketIndex(~quint64(0)), Histogram::BucketCount - 1);
+
+    // and report the largest value recorded rather than the bucket's bound
+    Histogram histogram;
+    histogram.record(10);
+    histogram.record(quint64(1) << 50);
+    QCOMPARE(histogram.percentile(100.0), quint64(1) << 50);
+    QCOMPARE(histogram.percentile(50.0), quint64(10));
+}
+
+void TestHistogram::testEmpty()
+{
+    Histogram histogram;
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.min(), quint64(0));
+    QCOMPARE(histogram.max(), quint64(0));
+    QCOMPARE(histogram.mean(), 0.0);
+    QCOMPARE(histogram.percentile(0.0), quint64(0));
+    QCOMPARE(histogram.percentile(50.0), quint64(0));
+    QCOMPARE(histogram.percentile(100.0), quint64(0));
+}
+
+void TestHistogram::testUniformDistribution()
+{
+    Histogram histogram;
+    for (quint64 value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    QCOMPARE(histogram.count(), quint64(1000));
+    QCOMPARE(histogram.min(), quint64(1));
+    QCOMPARE(histogram.max(), quint64(1000));
+    QCOMPARE(histogram.mean(), 500.5);
+
+    // The 500th value is 500, reported as the top of its bucket [496, 503]
+    QCOMPARE(histogram.percentile(50.0), quint64(503));
+    QCOMPARE(histogram.percentile(50.0), Histogram::bucketUpperBound(Histogram::bucketIndex(500)));
+    // 990 is in [976, 991]
+    QCOMPARE(histogram.percentile(99.0), quint64(991));
+    // Exact below 32
+    QCOMPARE(histogram.percentile(0.0), quint64(1));
+    QCOMPARE(histogram.percentile(1.0), quint64(10));
+    // The bucket of 1000 ends at 1007 but nothing above 1000 was recorded
+    QCOMPARE(histogram.percentile(100.0), quint64(1000));
+
+    for (double percent : {10.0, 25.0, 75.0, 90.0, 95.0}) {
+        const quint64 exact = quint64(percent * 10 + 0.5);
+        const quint64 reported = histogram.percentile(percent);
+        QVERIFY(reported >= exact);
+        QVERIFY(reported - exact <= exact / Histogram::SubBucketCount);
+    }
+}
+
+void TestHistogram::testConstantDistribution()
+{
+    Histogram histogram;
+    for (int i = 0; i < 100; ++i) {
+        histogram.record(12345);
+    }
+    QCOMPARE(histogram.min(), quint64(12345));
+    QCOMPARE(histogram.max(), quint64(12345));
+    QCOMPARE(histogram.mean(), 12345.0);
+    QCOMPARE(histogram.percentile(0.0), quint64(12345));
+    QCOMPARE(histogram.percentile(50.0), quint64(12345));
+    QCOMPARE(histogram.percentile(99.9), quint64(12345));
+}
+
+void TestHistogram::testBimodalDistribution()
+{
+    Histogram histogram;
+    for (int i = 0; i < 90; ++i) {
+        histogram.record(10);
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(10000);
+    }
+    QCOMPARE(histogram.mean(), 1009.0);
+    QCOMPARE(histogram.percentile(50.0), quint64(10));
+    QCOMPARE(histogram.percentile(90.0), quint64(10));
+    QCOMPARE(histogram.percentile(91.0), quint64(10000));
+    QCOMPARE(histogram.percentile(99.0), quint64(10000));
+}
+
+void TestHistogram::testPercentileClamped()
+{
+    Histogram histogram;
+    histogram.record(5);
+    histogram.record(7);
+    QCOMPARE(histogram.percentile(-10.0), quint64(5));
+    QCOMPARE(histogram.percentile(250.0), quint64(7));
+}
+
+void TestHistogram::testReset()
+{
+    Histogram histogram;
+    histogram.record(3);
+    histogram.record(3000);
+    histogram.reset();
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.min(), quint64(0));
+    QCOMPARE(histogram.max(), quint64(0));
+    QCOMPARE(histogram.percentile(50.0), quint64(0));
+
+    histogram.record(42);
+    QCOMPARE(histogram.min(), quint64(42));
+    QCOMPARE(histogram.percentile(50.0), quint64(42));
+}
+
+QTEST_MAIN(TestHistogram)
+#include "test_histogram.moc"
@@ -0,0 +1,173 @@
+#include "MpscRing.h"
+#include <QtTest/QtTest>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+class TestMpscRing : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testCapacityRoundedUp();
+    void testFifoUntilFull();
+    void testWrapAround();
+    void testConsumedTracksMark();
+    void testValuesMovedOut();
+    void testConcurrentProducers();
+};
+
+void TestMpscRing::testCapacityRoundedUp()
+{
+    QCOMPARE(MpscRing<int>(0).capacity(), quint64(2));
+    QCOMPARE(MpscRing<int>(1).capacity(), quint64(2));
+    QCOMPARE(MpscRing<int>(5).capacity(), quint64(8));
+    QCOMPARE(MpscRing<int>(8).capacity(), quint64(8));
+    QCOMPARE(MpscRing<int>(1000).capacity(), quint64(1024));
+}
+
+void TestMpscRing::testFifoUntilFull()
+{
+    MpscRing<int> ring(4);
+    int value = -1;
+    QVERIFY(!ring.tryPop(value));
+
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(ring.tryPush(int(i)));
+    }
+    // A full ring refuses instead of overwriting
+    QVERIFY(!ring.tryPush(99));
+    QCOMPARE(ring.pushed(), quint64(4));
+
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(ring.tryPop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!ring.tryPop(value));
+
+    // Popping frees the slots again
+    QVERIFY(ring.tryPush(4));
+    QVERIFY(ring.tryPop(value));
+    QCOMPARE(value, 4);
+}
+
+void TestMpscRing::testWrapAround()
+{
+    // Many times round a small ring with it partly full at every step
+    MpscRing<int> ring(4);
+    int next = 0;
+    int expected = 0;
+    int value = -1;
+    for (int round = 0; round < 1000; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            QVERIFY(ring.tryPush(int(next++)));
+        }
+        for (int i = 0; i < 2; ++i) {
+            QVERIFY(ring.tryPop(value));
+            QCOMPARE(value, expected++);
+        }
+        if (round % 2 == 1) {
+            while (ring.tryPop(value)) {
+                QCOMPARE(value, expected++);
+            }
+        }
+    }
+    QCOMPARE(ring.pushed(), quint64(next));
+}
+
+void TestMpscRing::testConsumedTracksMark()
+{
+    MpscRing<int> ring(8);
+    int value = -1;
+    ring.tryPush(1);
+    ring.tryPush(2);
+    ring.tryPush(3);
+    QCOMPARE(ring.consumed(), quint64(0));
+
+    // Popped is not consumed until the consumer says so
+    ring.tryPop(value);
+    ring.tryPop(value);
+    QCOMPARE(ring.consumed(), quint64(0));
+    ring.markConsumed();
+    QCOMPARE(ring.consumed(), quint64(2));
+    QVERIFY(ring.consumed() < ring.pushed());
+
+    ring.tryPop(value);
+    ring.markConsumed();
+    QCOMPARE(ring.consumed(), ring.pushed());
+}
+
+void TestMpscRing::testValuesMovedOut()
+{
+    MpscRing<QString> ring(2);
+    QString text = QString("first record");
+    QVERIFY(ring.tryPush(std::move(text)));
+    QVERIFY(ring.tryPush(QString("second record")));
+
+    QString value;
+    QVERIFY(ring.tryPop(value));
+    QCOMPARE(value, QString("first record"));
+    QVERIFY(ring.tryPop(value));
+    QCOMPARE(value, QString("second record"));
+}
+
+void TestMpscRing::testConcurrentProducers()
+{
+    // Producers tag each value with their index and a sequence number; a small ring keeps
+    // them contending for slots and running into a full ring
+    constexpr int ProducerCount = 4;
+    constexpr quint64 PerProducer = 20000;
+    MpscRing<quint64> ring(64);
+
+    QVector<QThread*> producers;
+    for (int producer = 0; producer < ProducerCount; ++producer) {
+        producers.append(QThread::create([&ring, producer]() {
+            for (quint64 sequence = 0; sequence < PerProducer; ++sequence) {
+                quint64 value = (quint64(producer) << 32) | sequence;
+                while (!ring.tryPush(std::move(value))) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }));
+        producers.last()->start();
+    }
+
+    // Each producer's values arrive in its own order, none lost or repeated
+    QVector<quint64> nextSequence(ProducerCount, 0);
+    quint64 received = 0;
+    bool ordered = true;
+    while (received < ProducerCount * PerProducer) {
+        quint64 value = 0;
+        if (!ring.tryPop(value)) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        const int producer = int(value >> 32);
+        const quint64 sequence = value & 0xffffffff;
+        if (producer >= ProducerCount || sequence != nextSequence[producer]) {
+            ordered = false;
+            break;
+        }
+        ++nextSequence[producer];
+        ++received;
+    }
+
+    for (QThread* thread : producers) {
+        if (!ordered) {
+            // Let the producers finish so the threads can be deleted
+            quint64 value = 0;
+            while (!thread->wait(10)) {
+                while (ring.tryPop(value)) {
+                }
+            }
+        }
+        thread->wait();
+        delete thread;
+    }
+    QVERIFY(ordered);
+    QCOMPARE(ring.pushed(), ProducerCount * PerProducer);
+    quint64 value = 0;
+    QVERIFY(!ring.tryPop(value));
+}
+
+QTEST_MAIN(TestMpscRing)
+#include "test_mpsc_ring.moc"
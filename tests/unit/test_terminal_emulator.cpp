@@ -0,0 +1,89 @@
+#include "TerminalEmulator.h"
+#include <QtTest/QtTest>
+#include <QByteArray>
+#include <QString>
+
+namespace {
+
+// Text of one screen row with trailing blanks trimmed
+QString rowText(const TerminalEmulator& emulator, int row)
+{
+    const TerminalScreen& screen = emulator.screen();
+    QString text;
+    for (const TerminalCell& cell : screen.line(row).cells) {
+        cell.appendText(text, screen.clusters());
+    }
+    while (text.endsWith(QLatin1Char(' '))) {
+        text.chop(1);
+    }
+    return text;
+}
+
+} // namespace
+
+class TestTerminalEmulator : public QObject {
+    Q_OBJECT
+
+private slots:
+    // UTF-8 stream decoding tests
+    void testSplitUtf8Character();
+    void testSplitUtf8SurrogatePair();
+    void testTruncatedUtf8BeforeEscape();
+    void testMalformedUtf8();
+};
+
+void TestTerminalEmulator::testSplitUtf8Character()
+{
+    TerminalEmulator emulator(4, 10);
+
+    // U+4E16 is E4 B8 96; the first read ends after two of its bytes
+    emulator.processData(QByteArray("a\xe4\xb8"));
+    QCOMPARE(rowText(emulator, 0), QString("a"));
+    QCOMPARE(emulator.screen().cursorCol(), 1);
+
+    emulator.processData(QByteArray("\x96" "b"));
+    QCOMPARE(rowText(emulator, 0), QString("a") + QChar(0x4e16) + QString("b"));
+    QCOMPARE(emulator.screen().cellAt(0, 1).width, quint8(2));
+    QCOMPARE(emulator.screen().cursorCol(), 4);
+}
+
+void TestTerminalEmulator::testSplitUtf8SurrogatePair()
+{
+    TerminalEmulator emulator(4, 10);
+
+    // U+1F600 (F0 9F 98 80) one byte per read
+    for (char byte : QByteArray("\xf0\x9f\x98\x80")) {
+        emulator.processData(QByteArray(1, byte));
+    }
+    QString expected;
+    expected.append(QChar::highSurrogate(0x1f600));
+    expected.append(QChar::lowSurrogate(0x1f600));
+    QCOMPARE(rowText(emulator, 0), expected);
+    QCOMPARE(emulator.screen().cursorCol(), 2);
+}
+
+void TestTerminalEmulator::testTruncatedUtf8BeforeEscape()
+{
+    TerminalEmulator emulator(4, 10);
+
+    // A lead byte that is never completed is replaced; the sequence after it still runs
+    emulator.processData(QByteArray("x\xe4"));
+    emulator.processData(QByteArray("\x1b[2;1Hy"));
+    QCOMPARE(rowText(emulator, 0), QString("x") + QChar(0xfffd));
+    QCOMPARE(rowText(emulator, 1), QString("y"));
+}
+
+void TestTerminalEmulator::testMalformedUtf8()
+{
+    TerminalEmulator emulator(4, 20);
+
+    // Stray continuation byte, overlong "/", encoded surrogate, past U+10FFFF
+    emulator.processData(QByteArray("a\x80" "b\xc0\xaf" "c\xed\xa0\x80" "d\xf4\x90\x80\x80" "e"));
+    const QString bad(QChar(0xfffd));
+    QCOMPARE(rowText(emulator, 0),
+             QString("a") + bad + QString("b") + bad + QString("c") + bad + QString("d") + bad +
+                 QString("e"));
+}
+
+QTEST_MAIN(TestTerminalEmulator)
+#include "test_terminal_emulator.moc"
@@ -0,0 +1,359 @@
+#include "TerminalScreen.h"
+#include <QtTest/QtTest>
+#include <QString>
+
+namespace {
+
+void put(TerminalScreen& screen, const QString& text)
+{
+    screen.putText(text.constData(), text.size());
+}
+
+// Text of one screen row, without the right halves of wide characters
+QString rowText(const TerminalScreen& screen, int row)
+{
+    QString text;
+    for (const TerminalCell& cell : screen.line(row).cells) {
+        cell.appendText(text, screen.clusters());
+    }
+    return text;
+}
+
+QString rowText(const TerminalScreen& screen, const TerminalScrollback::RowView& view)
+{
+    QString text;
+    for (int col = 0; col < view.length; ++col) {
+        view.cells[col].appendText(text, screen.clusters());
+    }
+    return text;
+}
+
+QString cellText(const TerminalScreen& screen, int row, int col)
+{
+    QString text;
+    screen.cellAt(row, col).appendText(text, screen.clusters());
+    return text;
+}
+
+} // namespace
+
+class TestTerminalScreen : public QObject {
+    Q_OBJECT
+
+private slots:
+    // Wide and combining character tests
+    void testWideCharAtLastColumn();
+    void testOverwriteWideCharHalf();
+    void testCombiningMarks();
+    void testControlsSkipped();
+    void testClusterIdsReclaimed();
+
+    // Reflow tests
+    void testResizeNarrowWideNarrow();
+    void testResizePendingWrap();
+    void testScrolledWrappedLineJoined();
+    void testAlternateBufferCropped();
+    void testResizeWideAcrossWrapColumn();
+    void testResizeWideIntoScrollback();
+};
+
+void TestTerminalScreen::testWideCharAtLastColumn()
+{
+    // Two columns left: the wide character fits and the cursor waits to wrap
+    TerminalScreen fits(3, 5);
+    put(fits, QString::fromUtf8("abc世"));
+    QCOMPARE(fits.cellAt(0, 3).width, quint8(2));
+    QCOMPARE(fits.cellAt(0, 4).width, quint8(0));
+    QVERIFY(!fits.line(0).wrapped);
+    QCOMPARE(fits.cursorRow(), 0);
+    QCOMPARE(fits.cursorCol(), 5);
+
+    // One column left: it is padded and moves to the next row whole
+    TerminalScreen screen(3, 5);
+    put(screen, QString::fromUtf8("abcd世"));
+    QCOMPARE(rowText(screen, 0), QString("abcd"));
+    QCOMPARE(screen.cellAt(0, 4).width, quint8(0));
+    QVERIFY(screen.line(0).wrapped);
+    QCOMPARE(cellText(screen, 1, 0), QString::fromUtf8("世"));
+    QCOMPARE(screen.cellAt(1, 0).width, quint8(2));
+    QCOMPARE(screen.cellAt(1, 1).width, quint8(0));
+    QCOMPARE(screen.cursorRow(), 1);
+    QCOMPARE(screen.cursorCol(), 2);
+}
+
+void TestTerminalScreen::testOverwriteWideCharHalf()
+{
+    TerminalScreen screen(2, 6);
+    put(screen, QString::fromUtf8("世界"));
+
+    // Writing over the right half of 世 blanks its left half
+    screen.setCursorPos(0, 1);
+    put(screen, QString("x"));
+    QCOMPARE(rowText(screen, 0), QString::fromUtf8(" x界  "));
+    QCOMPARE(screen.cellAt(0, 0).width, quint8(1));
+
+    // Writing over the left half of 界 blanks its right half
+    put(screen, QString("y"));
+    QCOMPARE(rowText(screen, 0), QString(" xy   "));
+    for (int col = 0; col < screen.cols(); ++col) {
+        QCOMPARE(screen.cellAt(0, col).width, quint8(1));
+    }
+
+    // A wide character over two others takes both columns whole
+    screen.setCursorPos(0, 1);
+    put(screen, QString::fromUtf8("世"));
+    QCOMPARE(rowText(screen, 0), QString::fromUtf8(" 世   "));
+    QCOMPARE(screen.cursorCol(), 3);
+}
+
+void TestTerminalScreen::testCombiningMarks()
+{
+    const QChar acute(0x301);
+    TerminalScreen screen(2, 10);
+    put(screen, QString("e") + acute + QString::fromUtf8("世") + acute + QString("e") + acute);
+
+    // Marks join the character before them and take no column
+    QVERIFY(screen.cellAt(0, 0).isCluster());
+    QCOMPARE(cellText(screen, 0, 0), QString("e") + acute);
+    QVERIFY(screen.cellAt(0, 1).isCluster());
+    QCOMPARE(screen.cellAt(0, 1).width, quint8(2));
+    QCOMPARE(cellText(screen, 0, 1), QString::fromUtf8("世") + acute);
+    QCOMPARE(screen.cursorCol(), 4);
+
+    // The same cluster gets the same id
+    QCOMPARE(screen.cellAt(0, 3).character, screen.cellAt(0, 0).character);
+    QCOMPARE(screen.clusters().size(), 2);
+
+    // With no character before it on the row, a mark is dropped
+    screen.setCursorPos(1, 0);
+    put(screen, QString(acute));
+    QCOMPARE(rowText(screen, 1), QString(10, QLatin1Char(' ')));
+
+    // Tables belong to their screen
+    TerminalScreen other(2, 10);
+    QCOMPARE(other.clusters().size(), 0);
+    put(other, QString("a") + acute);
+    QCOMPARE(cellText(other, 0, 0), QString("a") + acute);
+    QCOMPARE(cellText(screen, 0, 0), QString("e") + acute);
+}
+
+void TestTerminalScreen::testControlsSkipped()
+{
+    TerminalScreen screen(2, 10);
+
+    // C0 controls, DEL and C1 controls take no cell, inside an ASCII run or at its start
+    put(screen, QString("\x01" "ab\n\x1b" "c\x7f" "d") + QChar(0x85) + QString("e\t"));
+    QCOMPARE(rowText(screen, 0), QString("abcde     "));
+    QCOMPARE(screen.cursorCol(), 5);
+    QCOMPARE(screen.cursorRow(), 0);
+}
+
+void TestTerminalScreen::testClusterIdsReclaimed()
+{
+    // More distinct clusters than the table holds, written to a screen that keeps no
+    // history, so most of them are gone by the time the table fills up
+    TerminalScreen screen(2, 80);
+    screen.setMaxScrollback(0);
+    QString text;
+    int clusters = 0;
+    const char32_t markRanges[][2] = {{0x300, 0x370}, {0x1dc0, 0x1dfa}};
+    for (const auto& range : markRanges) {
+        for (char32_t mark = range[0]; mark < range[1]; ++mark) {
+            for (char32_t base = 0x100; base < 0x2b0; ++base) {
+                text += QChar(static_cast<char16_t>(base));
+                text += QChar(static_cast<char16_t>(mark));
+                ++clusters;
+            }
+        }
+    }
+    QVERIFY(clusters > ClusterTable::Capacity);
+    put(screen, text);
+
+    // Every cluster still on screen reads back as written
+    QCOMPARE(rowText(screen, 0) + rowText(screen, 1), text.right(2 * 2 * screen.cols()));
+    QVERIFY(screen.clusters().size() <= ClusterTable::Capacity);
+}
+
+void TestTerminalScreen::testResizeNarrowWideNarrow()
+{
+    TerminalScreen screen(4, 10);
+    put(screen, QString("abcdefghijklmno"));
+    QCOMPARE(rowText(screen, 0), QString("abcdefghij"));
+    QCOMPARE(rowText(screen, 1), QString("klmno     "));
+    QVERIFY(screen.line(0).wrapped);
+    QCOMPARE(screen.cursorRow(), 1);
+    QCOMPARE(screen.cursorCol(), 5);
+
+    // Wider: the soft-wrapped rows join into one
+    screen.resize(4, 20);
+    QCOMPARE(rowText(screen, 0), QString("abcdefghijklmno     "));
+    QVERIFY(!screen.line(0).wrapped);
+    QCOMPARE(rowText(screen, 1), QString(20, QLatin1Char(' ')));
+    QCOMPARE(screen.cursorRow(), 0);
+    QCOMPARE(screen.cursorCol(), 15);
+
+    // Narrower: three full rows, and the cursor waits to wrap after the last one
+    screen.resize(4, 5);
+    QCOMPARE(rowText(screen, 0), QString("abcde"));
+    QCOMPARE(rowText(screen, 1), QString("fghij"));
+    QCOMPARE(rowText(screen, 2), QString("klmno"));
+    QVERIFY(screen.line(0).wrapped);
+    QVERIFY(screen.line(1).wrapped);
+    QVERIFY(!screen.line(2).wrapped);
+    QCOMPARE(screen.cursorRow(), 2);
+    QCOMPARE(screen.cursorCol(), 5);
+    QVERIFY(screen.scrollback().isEmpty());
+
+    // And back to where it started
+    screen.resize(4, 10);
+    QCOMPARE(rowText(screen, 0), QString("abcdefghij"));
+    QCOMPARE(rowText(screen, 1), QString("klmno     "));
+    QCOMPARE(screen.cursorRow(), 1);
+    QCOMPARE(screen.cursorCol(), 5);
+}
+
+void TestTerminalScreen::testResizePendingWrap()
+{
+    // A full row leaves the cursor in the pending-wrap column
+    TerminalScreen screen(3, 10);
+    put(screen, QString("0123456789"));
+    QCOMPARE(screen.cursorRow(), 0);
+    QCOMPARE(screen.cursorCol(), 10);
+
+    // Split in two, the cursor stays after the last character rather than on a new row
+    screen.resize(3, 5);
+    QCOMPARE(rowText(screen, 0), QString("01234"));
+    QCOMPARE(rowText(screen, 1), QString("56789"));
+    QCOMPARE(screen.cursorRow(), 1);
+    QCOMPARE(screen.cursorCol(), 5);
+
+    // The next character wraps and continues the same line
+    put(screen, QString("x"));
+    QVERIFY(screen.line(1).wrapped);
+    QCOMPARE(rowText(screen, 2), QString("x    "));
+    QCOMPARE(screen.cursorRow(), 2);
+    QCOMPARE(screen.cursorCol(), 1);
+
+    // Wider again, all of it is one row
+    screen.resize(3, 12);
+    QCOMPARE(rowText(screen, 0), QString("0123456789x "));
+    QCOMPARE(screen.cursorRow(), 0);
+    QCOMPARE(screen.cursorCol(), 11);
+}
+
+void TestTerminalScreen::testScrolledWrappedLineJoined()
+{
+    TerminalScreen screen(2, 10);
+    put(screen, QString("abcdefghijklmnopqrstuvwxy"));
+    screen.carriageReturn();
+    screen.newLine();
+
+    // Both full rows scrolled off one at a time and went into one history line
+    const TerminalScrollback& scrollback = screen.scrollback();
+    QCOMPARE(scrollback.lineCount(), 1);
+    QCOMPARE(scrollback.rowCount(), 2);
+    QCOMPARE(rowText(screen, scrollback.rowFromBottom(1)), QString("abcdefghij"));
+    QVERIFY(scrollback.rowFromBottom(1).wrapped);
+    QCOMPARE(rowText(screen, scrollback.rowFromBottom(0)), QString("klmnopqrst"));
+    QCOMPARE(rowText(screen, 0), QString("uvwxy     "));
+
+    // History reflows as a whole line
+    screen.scrollback().setWidth(20);
+    QCOMPARE(scrollback.rowCount(), 1);
+    QCOMPARE(rowText(screen, scrollback.rowFromBottom(0)), QString("abcdefghijklmnopqrst"));
+}
+
+void TestTerminalScreen::testAlternateBufferCropped()
+{
+    TerminalScreen screen(4, 10);
+    put(screen, QString("abcdefghijklmno"));
+    screen.useAlternateBuffer();
+    put(screen, QString("0123456789AB"));
+
+    // Full-screen programs redraw on resize, so their rows are only cut to size
+    screen.resize(4, 5);
+    QCOMPARE(rowText(screen, 0), QString("01234"));
+    QCOMPARE(rowText(screen, 1), QString("AB   "));
+    QCOMPARE(rowText(screen, 2), QString("     "));
+    QCOMPARE(screen.cursorRow(), 1);
+    QCOMPARE(screen.cursorCol(), 2);
+
+    // Widening pads them with blanks; what was cut off does not come back
+    screen.resize(4, 8);
+    QCOMPARE(rowText(screen, 0), QString("01234   "));
+    QCOMPARE(rowText(screen, 1), QString("AB      "));
+
+    // The normal screen underneath was reflowed both times
+    screen.useNormalBuffer();
+    QCOMPARE(rowText(screen, 0), QString("abcdefgh"));
+    QCOMPARE(rowText(screen, 1), QString("ijklmno "));
+    QVERIFY(screen.line(0).wrapped);
+    QVERIFY(screen.scrollback().isEmpty());
+}
+
+void TestTerminalScreen::testResizeWideAcrossWrapColumn()
+{
+    // "ab世界" fills a six-column row exactly and "cd" wraps
+    TerminalScreen screen(5, 6);
+    put(screen, QString::fromUtf8("ab世界cd"));
+    QCOMPARE(rowText(screen, 0), QString::fromUtf8("ab世界"));
+    QCOMPARE(rowText(screen, 1), QString("cd    "));
+    QVERIFY(screen.line(0).wrapped);
+
+    // At five columns 界 would straddle the edge, so it moves down whole
+    screen.resize(5, 5);
+    QCOMPARE(rowText(screen, 0), QString::fromUtf8("ab世"));
+    QCOMPARE(screen.cellAt(0, 4).width, quint8(0));
+    QVERIFY(screen.line(0).wrapped);
+    QCOMPARE(rowText(screen, 1), QString::fromUtf8("界cd "));
+    QCOMPARE(screen.cellAt(1, 0).width, quint8(2));
+    QCOMPARE(screen.cellAt(1, 1).width, quint8(0));
+    QVERIFY(!screen.line(1).wrapped);
+    QCOMPARE(screen.cursorRow(), 1);
+    QCOMPARE(screen.cursorCol(), 4);
+
+    // Going back drops the padding rather than keeping it as a space
+    screen.resize(5, 6);
+    QCOMPARE(rowText(screen, 0), QString::fromUtf8("ab世界"));
+    QCOMPARE(rowText(screen, 1), QString("cd    "));
+    QCOMPARE(screen.cursorRow(), 1);
+    QCOMPARE(screen.cursorCol(), 2);
+
+    // One column wider, everything fits on the first row
+    screen.resize(5, 8);
+    QCOMPARE(rowText(screen, 0), QString::fromUtf8("ab世界cd"));
+    QVERIFY(!screen.line(0).wrapped);
+    QCOMPARE(screen.cursorRow(), 0);
+    QCOMPARE(screen.cursorCol(), 8);
+}
+
+void TestTerminalScreen::testResizeWideIntoScrollback()
+{
+    TerminalScreen screen(2, 6);
+    put(screen, QString::fromUtf8("ab世界cd"));
+
+    // At three columns the line takes "ab", "世", "界c", "d"; the top two scroll off
+    screen.resize(2, 3);
+    QCOMPARE(rowText(screen, 0), QString::fromUtf8("界c"));
+    QCOMPARE(rowText(screen, 1), QString("d  "));
+    QCOMPARE(screen.cursorRow(), 1);
+    QCOMPARE(screen.cursorCol(), 1);
+
+    // Scrollback joins the rows without their padding and splits them the same way
+    const TerminalScrollback& scrollback = screen.scrollback();
+    QCOMPARE(scrollback.rowCount(), 2);
+    const TerminalScrollback::RowView top = scrollback.rowFromBottom(1);
+    QCOMPARE(rowText(screen, top), QString("ab"));
+    QVERIFY(top.wrapped);
+    const TerminalScrollback::RowView bottom = scrollback.rowFromBottom(0);
+    QCOMPARE(rowText(screen, bottom), QString::fromUtf8("世"));
+    QCOMPARE(bottom.length, 2);
+
+    // Wider history puts the pair back on one row
+    screen.scrollback().setWidth(4);
+    QCOMPARE(scrollback.rowCount(), 1);
+    QCOMPARE(rowText(screen, scrollback.rowFromBottom(0)), QString::fromUtf8("ab世"));
+}
+
+QTEST_MAIN(TestTerminalScreen)
+#include "test_terminal_screen.moc"
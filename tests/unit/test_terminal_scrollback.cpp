@@ -0,0 +1,195 @@
+#include "TerminalScrollback.h"
+#include <QtTest/QtTest>
+#include <QString>
+#include <QStringList>
+
+namespace {
+
+const ClusterTable noClusters;
+
+TerminalLine makeRow(const QString& text, bool wrapped = false)
+{
+    TerminalLine row;
+    for (QChar ch : text) {
+        TerminalCell cell;
+        cell.character = ch.unicode();
+        row.cells.append(cell);
+    }
+    row.wrapped = wrapped;
+    return row;
+}
+
+QString rowText(const TerminalScrollback::RowView& view)
+{
+    QString text;
+    for (int col = 0; col < view.length; ++col) {
+        view.cells[col].appendText(text, noClusters);
+    }
+    return text;
+}
+
+// Line n of the eviction test: its number padded with dots, one to three rows at width 5
+QString numberedLine(int n)
+{
+    QString text = QString::number(n);
+    return text + QString((n % 3) * 5 + 4 - text.size(), QLatin1Char('.'));
+}
+
+// Rows of lines first..last split at width, oldest first
+QStringList splitRows(int first, int last, int width)
+{
+    QStringList rows;
+    for (int n = first; n <= last; ++n) {
+        const QString line = numberedLine(n);
+        for (int start = 0; start < line.size(); start += width) {
+            rows.append(line.mid(start, width));
+        }
+    }
+    return rows;
+}
+
+// Checks every row through both rowFromBottom() and the iterator
+void compareRows(const TerminalScrollback& scrollback, const QStringList& expected)
+{
+    QCOMPARE(scrollback.rowCount(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        QCOMPARE(rowText(scrollback.rowFromBottom(i)), expected[expected.size() - 1 - i]);
+    }
+    QVERIFY(!scrollback.rowFromBottom(expected.size()).valid);
+
+    QStringList iterated;
+    for (const TerminalScrollback::RowView& view : scrollback) {
+        iterated.append(rowText(view));
+    }
+    QCOMPARE(iterated, expected);
+}
+
+} // namespace
+
+class TestTerminalScrollback : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testContinueWrappedRow();
+    void testRowsAfterSetWidth();
+    void testEvictAcrossPageBoundary();
+    void testFindBeforeLayout();
+};
+
+void TestTerminalScrollback::testContinueWrappedRow()
+{
+    TerminalScrollback scrollback(100, 4);
+    scrollback.pushRow(makeRow("abcd", true));
+    scrollback.pushRow(makeRow("ef  "));
+
+    // One line, trailing blanks trimmed once it is complete
+    QCOMPARE(scrollback.lineCount(), 1);
+    QCOMPARE(scrollback.cellCount(), qint64(6));
+    QCOMPARE(scrollback.rowCount(), 2);
+    QCOMPARE(rowText(scrollback.rowFromBottom(1)), QString("abcd"));
+    QVERIFY(scrollback.rowFromBottom(1).wrapped);
+    QCOMPARE(rowText(scrollback.rowFromBottom(0)), QString("ef"));
+    QVERIFY(!scrollback.rowFromBottom(0).wrapped);
+
+    // Continuing a line that is already laid out grows it in place
+    scrollback.pushRow(makeRow("ghij", true));
+    QCOMPARE(scrollback.rowCount(), 3);
+    scrollback.pushRow(makeRow("klmn", true));
+    scrollback.pushRow(makeRow("o"));
+    QCOMPARE(scrollback.lineCount(), 2);
+    QCOMPARE(scrollback.rowCount(), 5);
+    QCOMPARE(rowText(scrollback.rowFromBottom(0)), QString("o"));
+    QCOMPARE(rowText(scrollback.rowFromBottom(2)), QString("ghij"));
+    QCOMPARE(rowText(scrollback.rowFromBottom(3)), QString("ef"));
+
+    // closeLine() ends the line even though the last row was wrapped
+    scrollback.pushRow(makeRow("pq", true));
+    scrollback.closeLine();
+    scrollback.pushRow(makeRow("rs"));
+    QCOMPARE(scrollback.lineCount(), 4);
+    QCOMPARE(rowText(scrollback.rowFromBottom(1)), QString("pq"));
+}
+
+void TestTerminalScrollback::testRowsAfterSetWidth()
+{
+    TerminalScrollback scrollback(100, 4);
+    scrollback.pushRow(makeRow("0123456789"));
+    scrollback.pushRow(makeRow("abc"));
+    scrollback.pushRow(makeRow(""));
+    compareRows(scrollback, {"0123", "4567", "89", "abc", ""});
+
+    scrollback.setWidth(10);
+    QCOMPARE(scrollback.width(), 10);
+    compareRows(scrollback, {"0123456789", "abc", ""});
+
+    // Rows are found before rowCount() has laid out the whole history
+    scrollback.setWidth(3);
+    QCOMPARE(rowText(scrollback.rowFromBottom(2)), QString("9"));
+    QVERIFY(!scrollback.rowFromBottom(2).wrapped);
+    QVERIFY(scrollback.rowFromBottom(3).wrapped);
+    compareRows(scrollback, {"012", "345", "678", "9", "abc", ""});
+
+    // A width below one column is taken as one
+    scrollback.setWidth(0);
+    QCOMPARE(scrollback.width(), 1);
+    QCOMPARE(scrollback.rowCount(), 14);
+}
+
+void TestTerminalScrollback::testEvictAcrossPageBoundary()
+{
+    // Pages hold 256 lines; lay everything out before lines start to leave so
+    // eviction has to fix up the row positions of the laid-out oldest page
+    TerminalScrollback scrollback(300, 5);
+    for (int n = 0; n < 300; ++n) {
+        scrollback.pushRow(makeRow(numberedLine(n)));
+    }
+    compareRows(scrollback, splitRows(0, 299, 5));
+
+    for (int n = 300; n < 360; ++n) {
+        scrollback.pushRow(makeRow(numberedLine(n)));
+    }
+    QCOMPARE(scrollback.lineCount(), 300);
+    compareRows(scrollback, splitRows(60, 359, 5));
+
+    // Past the end of the first page, which is dropped entirely
+    for (int n = 360; n < 560; ++n) {
+        scrollback.pushRow(makeRow(numberedLine(n)));
+    }
+    QCOMPARE(scrollback.lineCount(), 300);
+    compareRows(scrollback, splitRows(260, 559, 5));
+
+    // Lowering the limit evicts the same way
+    scrollback.setMaxLines(10);
+    compareRows(scrollback, splitRows(550, 559, 5));
+    scrollback.setMaxLines(0);
+    QVERIFY(scrollback.isEmpty());
+    QCOMPARE(scrollback.rowCount(), 0);
+    QCOMPARE(scrollback.cellCount(), qint64(0));
+}
+
+void TestTerminalScrollback::testFindBeforeLayout()
+{
+    // Three pages of one-character lines and a longer one in the oldest page
+    TerminalScrollback scrollback(1000, 10);
+    for (int n = 0; n < 600; ++n) {
+        scrollback.pushRow(makeRow(n == 5 ? QString("xxxxxxxxxxneedle") : QString::number(n % 10)));
+    }
+
+    // "needle" starts on the second row of line 5, below which 594 one-row lines lie
+    QCOMPARE(scrollback.findFromBottom("needle", noClusters), 594);
+    QCOMPARE(scrollback.findFromBottom("needle", noClusters, 594), 594);
+    QCOMPARE(scrollback.findFromBottom("needle", noClusters, 595), -1);
+    QCOMPARE(scrollback.findFromBottom("NEEDLE", noClusters, 0, Qt::CaseInsensitive), 594);
+    QCOMPARE(scrollback.findFromBottom("7", noClusters, 0), 2);
+    QCOMPARE(scrollback.findFromBottom("7", noClusters, 3), 12);
+
+    // After a resize nothing is laid out again; at five columns the match is on the
+    // third row of "xxxxx", "xxxxx", "needl", "e"
+    scrollback.setWidth(5);
+    QCOMPARE(scrollback.findFromBottom("needle", noClusters), 595);
+    QCOMPARE(scrollback.rowCount(), 603);
+    QCOMPARE(rowText(scrollback.rowFromBottom(595)), QString("needl"));
+}
+
+QTEST_MAIN(TestTerminalScrollback)
+#include "test_terminal_scrollback.moc"
@@ -0,0 +1,131 @@
+#include "BinaryLog.h"
+#include <QByteArray>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <cstdio>
+
+namespace {
+
+struct DecodeStats {
+    qint64 records = 0;
+    qint64 printed = 0;
+};
+
+// Prints the records of one file. Category and format ids are local to the file.
+bool decodeFile(const QString& path, const QString& categoryFilter, DecodeStats& stats,
+                QString& errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    // A log that is still being written keeps its full segment size; map it rather
+    // than reading megabytes of zero tail
+    const qint64 size = file.size();
+    const char* data = nullptr;
+    QByteArray contents;
+    if (size > 0) {
+        data = reinterpret_cast<const char*>(file.map(0, size));
+    }
+    if (!data) {
+        contents = file.readAll();
+        data = contents.constData();
+    }
+
+    if (!BinaryLog::checkFileHeader(data, size)) {
+        errorMessage = "not a binary log (bad magic or version)";
+        return false;
+    }
+
+    QHash<quint16, QByteArray> categories;
+    QHash<quint32, QString> formats;
+
+    qint64 offset = BinaryLog::FileHeaderSize;
+    BinaryLog::RecordHeader header;
+    QByteArray payload;
+    while (BinaryLog::readRecord(data, size, offset, header, payload)) {
+        ++stats.records;
+
+        QString message;
+        switch (header.kind) {
+        case BinaryLog::RecordKind::CategoryDef:
+            categories.insert(header.category, payload);
+            continue;
+        case BinaryLog::RecordKind::FormatDef:
+            formats.insert(header.format, QString::fromUtf8(payload));
+            continue;
+        case BinaryLog::RecordKind::Message:
+            message = BinaryLog::render(formats.value(header.format,
+                                                      QString("<format %1>").arg(header.format)),
+                                        BinaryLog::decodeArgs(payload));
+            break;
+        case BinaryLog::RecordKind::Text:
+            message = QString::fromUtf8(payload);
+            break;
+        default:
+            continue;
+        }
+
+        QByteArray category = categories.value(header.category, "?");
+        if (!categoryFilter.isEmpty() && !QString::fromUtf8(category).startsWith(categoryFilter)) {
+            continue;
+        }
+
+        QByteArray line =
+            BinaryLog::formatLine(header.timestampUs, header.level, category.constData(), message);
+        fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stdout);
+        ++stats.printed;
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("blog-decode");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Print binary SSH Client logs in the text log format.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("files", "Binary log files (.blog), decoded in order.",
+                                 "files...");
+
+    QCommandLineOption categoryOption("category",
+                                      "Only print records whose category starts with <prefix>.",
+                                      "prefix");
+    QCommandLineOption statsOption("stats", "Print record counts to stderr.");
+    parser.addOptions({categoryOption, statsOption});
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    int exitCode = 0;
+    DecodeStats stats;
+    for (const QString& path : files) {
+        QString errorMessage;
+        if (!decodeFile(path, parser.value(categoryOption), stats, errorMessage)) {
+            fprintf(stderr, "blog-decode: %s: %s\n", qPrintable(path),
+                    qPrintable(errorMessage));
+            exitCode = 1;
+        }
+    }
+
+    if (parser.isSet(statsOption)) {
+        fprintf(stderr, "%lld records, %lld lines printed\n",
+                static_cast<long long>(stats.records), static_cast<long long>(stats.printed));
+    }
+
+    return exitCode;
+}
@@ -0,0 +1,181 @@
+#include "AllocTracker.h"
+#include "ControlScan.h"
+#include "TerminalEmulator.h"
+#include <QByteArray>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QtGlobal>
+#include <cstdio>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// Peak resident set size in bytes, or -1 when the platform does not report it
+qint64 peakMemoryBytes()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#ifdef Q_OS_MACOS
+    return static_cast<qint64>(usage.ru_maxrss);
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return -1;
+#endif
+}
+
+bool readInput(const QString& path, QByteArray& data, QString& errorMessage)
+{
+    QFile file;
+    bool opened = false;
+    if (path.isEmpty() || path == "-") {
+        opened = file.open(stdin, QIODevice::ReadOnly);
+    } else {
+        file.setFileName(path);
+        opened = file.open(QIODevice::ReadOnly);
+    }
+
+    if (!opened) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    data = file.readAll();
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("term-bench");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Feed terminal output through TerminalEmulator and report throughput.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("file", "Input file; reads stdin when omitted or '-'.");
+
+    QCommandLineOption rowsOption("rows", "Terminal rows (default 24).", "rows", "24");
+    QCommandLineOption colsOption("cols", "Terminal columns (default 80).", "cols", "80");
+    QCommandLineOption chunkOption("chunk",
+                                   "Bytes passed to processData() per call, like one "
+                                   "network read (default 4096).",
+                                   "bytes", "4096");
+    QCommandLineOption repeatOption("repeat", "Number of passes over the input (default 1).",
+                                    "count", "1");
+    QCommandLineOption jsonOption("json", "Print results as a JSON object.");
+    parser.addOptions({rowsOption, colsOption, chunkOption, repeatOption, jsonOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const int rows = parser.value(rowsOption).toInt();
+    const int cols = parser.value(colsOption).toInt();
+    const int chunkSize = parser.value(chunkOption).toInt();
+    const int repeat = parser.value(repeatOption).toInt();
+    if (rows <= 0 || cols <= 0 || chunkSize <= 0 || repeat <= 0) {
+        err << "term-bench: rows, cols, chunk and repeat must be positive\n";
+        return 2;
+    }
+
+    const QStringList positional = parser.positionalArguments();
+    const QString path = positional.isEmpty() ? QString() : positional.first();
+
+    // Load everything up front so disk and pipe I/O stay out of the measurement
+    QByteArray input;
+    QString errorMessage;
+    if (!readInput(path, input, errorMessage)) {
+        err << "term-bench: cannot read input: " << errorMessage << "\n";
+        return 1;
+    }
+    if (input.isEmpty()) {
+        err << "term-bench: input is empty\n";
+        return 1;
+    }
+
+    TerminalEmulator emulator(rows, cols);
+
+    AllocTracker::Counts allocationsBefore[AllocTracker::SubsystemCount];
+    for (int i = 0; i < AllocTracker::SubsystemCount; ++i) {
+        allocationsBefore[i] = AllocTracker::counts(static_cast<AllocTracker::Subsystem>(i));
+    }
+
+    // Chunks are views into input, so the timed loop does not copy them
+    QElapsedTimer timer;
+    timer.start();
+    for (int pass = 0; pass < repeat; ++pass) {
+        for (int offset = 0; offset < input.size(); offset += chunkSize) {
+            const int length = qMin(chunkSize, static_cast<int>(input.size()) - offset);
+            emulator.processData(QByteArray::fromRawData(input.constData() + offset, length));
+        }
+    }
+    const qint64 elapsedNs = qMax<qint64>(timer.nsecsElapsed(), 1);
+
+    const double seconds = elapsedNs / 1e9;
+    const double totalBytes = static_cast<double>(input.size()) * repeat;
+    const double mbPerSecond = totalBytes / (1024.0 * 1024.0) / seconds;
+    const quint64 sequences = emulator.sequenceCount();
+    const double sequencesPerSecond = sequences / seconds;
+    const qint64 peakMemory = peakMemoryBytes();
+
+    // Allocations made during the run per subsystem (ENABLE_ALLOC_TRACKING builds)
+    QStringList allocationFields;
+    QStringList allocationSummary;
+    for (int i = 0; i < AllocTracker::SubsystemCount && AllocTracker::isCompiledIn(); ++i) {
+        auto subsystem = static_cast<AllocTracker::Subsystem>(i);
+        const QString name = AllocTracker::subsystemName(subsystem);
+        quint64 count =
+            AllocTracker::counts(subsystem).allocations - allocationsBefore[i].allocations;
+        allocationFields << QString("\"%1\": %2").arg(name).arg(count);
+        allocationSummary << QString("%1 %2").arg(name).arg(count);
+    }
+
+    if (parser.isSet(jsonOption)) {
+        out << "{\"bytes\": " << QString::number(totalBytes, 'f', 0)
+            << ", \"seconds\": " << QString::number(seconds, 'f', 6)
+            << ", \"mb_per_second\": " << QString::number(mbPerSecond, 'f', 2)
+            << ", \"sequences\": " << sequences
+            << ", \"sequences_per_second\": " << QString::number(sequencesPerSecond, 'f', 0)
+            << ", \"peak_memory_bytes\": " << peakMemory << ", \"rows\": " << rows
+            << ", \"cols\": " << cols << ", \"chunk\": " << chunkSize
+            << ", \"scan\": \"" << Escape::controlScanImplementation() << "\"";
+        if (!allocationFields.isEmpty()) {
+            out << ", \"allocations\": {" << allocationFields.join(", ") << "}";
+        }
+        out << "}\n";
+    } else {
+        out << "input:        " << (path.isEmpty() ? QString("<stdin>") : path) << "\n";
+        out << "bytes:        " << QString::number(totalBytes, 'f', 0) << " (" << repeat
+            << " pass" << (repeat == 1 ? "" : "es") << ")\n";
+        out << "scan:         " << Escape::controlScanImplementation() << "\n";
+        out << "time:         " << QString::number(seconds * 1000.0, 'f', 2) << " ms\n";
+        out << "throughput:   " << QString::number(mbPerSecond, 'f', 2) << " MB/s\n";
+        out << "sequences:    " << sequences << " ("
+            << QString::number(sequencesPerSecond, 'f', 0) << "/s)\n";
+        out << "peak memory:  "
+            << (peakMemory < 0 ? QString("n/a")
+                               : QString::number(peakMemory / (1024.0 * 1024.0), 'f', 1) +
+                                     " MB")
+            << "\n";
+        if (!allocationSummary.isEmpty()) {
+            out << "allocations:  " << allocationSummary.join(", ") << "\n";
+        }
+    }
+
+    return 0;
+}